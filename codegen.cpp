@@ -0,0 +1,27 @@
+// Functions whose generated code is inspected by codegen.sh.
+//
+// Functions prefixed with elided_ must not contain any min/max, conditional move or floating-point comparison instruction: their source domains cover every value of their type, so clamping is elided at compile time.
+// Functions prefixed with clamped_ must contain some, which shows the inspection would notice a clamp.
+// Functions prefixed with vectorized_ must clamp with packed (SIMD) instructions, without any scalar floating-point comparison or branch.
+
+#include "numeric_domain.hpp"
+
+using namespace numeric_domain;
+
+extern "C" {
+
+float elided_uint8_to_float01(uint8_t v) { return domain_cast<float01,uint8_t>(v); }
+float elided_int16_to_float11(int16_t v) { return domain_cast<float11,int16_t>(v); }
+uint16_t elided_uint8_tag_to_uint12(uint8_t v) { return domain_cast<unsigned_int<12>,arithmetic_t<uint8_t>>(v); }
+int8_t elided_int16_to_int8(int16_t v) { return domain_cast<int8_t,int16_t>(v); }
+void elided_uint8_to_float01_batch(const uint8_t* in, float* out) { domain_cast<float01,uint8_t>(in, in + 1024, out); }
+void elided_int16_to_float11_batch(const int16_t* in, float* out) { domain_cast<float11,int16_t>(in, in + 1024, out); }
+void elided_int16_to_float11_wrap_batch(const int16_t* in, float* out) { domain_cast<float11,int16_t,wrap>(in, in + 1024, out); }
+void elided_uint8_tag_to_uint12_batch(const uint8_t* in, int* out) { domain_cast<unsigned_int<12>,arithmetic_t<uint8_t>>(in, in + 1024, out); }
+
+uint8_t clamped_uint12_to_uint8(int v) { return domain_cast<uint8_t,unsigned_int<12>>(v); }
+void clamped_float11_to_float01_batch(const float* in, float* out) { domain_cast<float01,float11>(in, in + 1024, out); }
+
+void vectorized_float11_to_float01_vector(const std::array<float, 4>* in, std::array<float, 4>* out) { *out = domain_cast<vector_t<float01, float01, float01, float01>, vector_t<float11, float11, float11, float01>>(*in); }
+
+}
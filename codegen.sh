@@ -0,0 +1,58 @@
+#!/bin/sh
+# Compile codegen.cpp and codegen_integer_only.cpp to assembly and check the instructions generated for each of their functions (see both files).
+# Only meaningful on x86-64 with GCC or Clang; skipped elsewhere.
+
+CXX=${CXX:-c++}
+
+case "$(uname -m)" in
+	x86_64|amd64) ;;
+	*) echo "codegen: skipped on $(uname -m)"; exit 0 ;;
+esac
+
+asm=$(mktemp)
+trap 'rm -f "$asm"' EXIT
+
+# Print the instructions of function $1.
+body() {
+	awk -v name="$1" '$0 == name ":" { inside = 1; next } inside && /^\t\.size|^\t\.cfi_endproc/ { exit } inside && /^\t[a-z]/ { print $1 }' "$asm"
+}
+
+failures=0
+check() { # function, pattern, whether the pattern must be found
+	if body "$1" | grep -Eq "$2"; then found=yes; else found=no; fi
+	if [ "$found" != "$3" ]; then
+		echo "codegen: FAILED: $1 ($2 expected: $3)"
+		failures=$((failures + 1))
+	fi
+}
+
+clamp='^v?p?(min|max)|^cmov|^v?u?comis'
+packed_clamp='^v?(min|max|cmp[a-z]*)ps$'
+floating='^v?(add|sub|mul|div|sqrt|min|max|cmp|round|movs|movap|movup)[a-z]*(ss|sd|ps|pd)$|^v?cvt|^v?f[a-z]'
+for source in codegen.cpp codegen_integer_only.cpp; do
+	$CXX -std=c++11 -O3 -DNDEBUG -S -o "$asm" "$source" || exit 1
+	for f in $(grep -o '^[a-z0-9_]* [a-z]*_[a-z0-9_]*(' "$source" | awk '{ print $2 }' | tr -d '('); do
+		case "$f" in
+			elided_*) check "$f" "$clamp" no ;;
+			clamped_*) check "$f" "$clamp" yes ;;
+			vectorized_*) check "$f" "$packed_clamp" yes; check "$f" '^v?u?comis|^j' no ;;
+			integer_only_*) check "$f" "$floating" no ;;
+		esac
+	done
+done
+
+# In integer-only mode, conversions computed in floating point must not compile, and must be rejected by the static assertions of integer-only mode rather than by any other error.
+rejection='which NUMERIC_DOMAIN_INTEGER_ONLY forbids'
+for n in 1 2 3 4 5 6 7 8; do
+	if $CXX -std=c++11 -fsyntax-only -DREJECTED=$n codegen_integer_only.cpp 2>"$asm"; then
+		echo "codegen: FAILED: floating-point conversion $n of codegen_integer_only.cpp compiles in integer-only mode"
+		failures=$((failures + 1))
+	elif ! grep -q "$rejection" "$asm"; then
+		echo "codegen: FAILED: floating-point conversion $n of codegen_integer_only.cpp fails to compile for another reason than integer-only mode:"
+		cat "$asm"
+		failures=$((failures + 1))
+	fi
+done
+
+if [ $failures -eq 0 ]; then echo "codegen: OK"; fi
+exit $failures
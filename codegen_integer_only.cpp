@@ -0,0 +1,41 @@
+// Functions whose generated code is inspected by codegen.sh, in integer-only mode (see NUMERIC_DOMAIN_INTEGER_ONLY).
+//
+// Functions prefixed with integer_only_ must not contain any floating-point instruction.
+// Each conversion selected by REJECTED is computed in floating point, so it must not compile: codegen.sh tries them one by one, and checks that each one is rejected by a static assertion of integer-only mode (not by any other error).
+
+#define NUMERIC_DOMAIN_INTEGER_ONLY
+#include "numeric_domain.hpp"
+#include "domain_reduce.hpp"
+
+using namespace numeric_domain;
+
+extern "C" {
+
+uint8_t integer_only_uint12_to_uint8(int v) { return domain_cast<uint8_t,unsigned_int<12>>(v); }
+int8_t integer_only_int16_to_int8(int16_t v) { return domain_cast<int8_t,int16_t>(v); }
+uint16_t integer_only_int16_to_uint16(int16_t v) { return domain_cast<uint16_t,int16_t>(v); }
+int integer_only_uint10_to_int12_wrap(int v) { return domain_cast<signed_int<12>,unsigned_int<10>,wrap>(v); }
+void integer_only_uint10_to_int16_batch(const int* in, int16_t* out) { domain_cast<int16_t,unsigned_int<10>>(in, in + 1024, out); }
+int integer_only_dynamic_int(int v, int tmin, int tmax, int umin, int umax) { return domain_cast(make_domain(umin, umax), v, make_domain(tmin, tmax)); }
+void integer_only_dynamic_int_batch(const int* in, uint16_t* out, int tmin, int tmax) { domain_cast(make_domain<uint16_t>(0, 4095), in, in + 1024, out, make_domain(tmin, tmax)); }
+int8_t integer_only_int16_to_int8_peak(const int16_t* in) { return domain_peak<int8_t,int16_t>(in, in + 1024); }
+
+#if REJECTED == 1
+float rejected(int v) { return domain_cast<float01,unsigned_int<12>>(v); }
+#elif REJECTED == 2
+uint8_t rejected(float v) { return domain_cast<uint8_t,float11>(v); }
+#elif REJECTED == 3
+float rejected(float v) { return domain_cast<float01,float11,unchecked>(v); }
+#elif REJECTED == 4
+float rejected(int v, int tmin, int tmax) { return domain_cast(make_domain(0.0f, 1.0f), v, make_domain(tmin, tmax)); }
+#elif REJECTED == 5
+int rejected(float v) { return make_caster(make_domain(0, 100), make_domain(0.0f, 1.0f))(v); }
+#elif REJECTED == 6
+int rejected(int v, int tmin, int tmax) { return make_coefficients(make_domain(0, 100), make_domain(tmin, tmax))(v); }
+#elif REJECTED == 7
+double rejected(const int16_t* in) { return domain_sum<int8_t,int16_t>(in, in + 1024); }
+#elif REJECTED == 8
+double rejected(const int16_t* in, const int8_t* other) { return domain_dot<int8_t,int16_t>(in, in + 1024, other); }
+#endif
+
+}
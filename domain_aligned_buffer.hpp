@@ -0,0 +1,109 @@
+#pragma once
+/**
+ * Buffers of values within a numeric domain, aligned to cache lines or huge pages.
+ * Part of numeric_domain (see numeric_domain.hpp for copyright and license information).
+ */
+
+#include "numeric_domain.hpp"
+#include <new>
+#include <cstdlib>
+#include <utility>
+#if defined(_WIN32)
+#include <malloc.h>
+#elif defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace numeric_domain {
+/**
+ * How the memory of an aligned_buffer is laid out.
+ *
+ *  - `cache_line`: aligned to 64 bytes, so that vector loads and streaming stores never straddle cache lines.
+ *  - `huge_page`: aligned to (and padded to a multiple of) 2 MiB, and on Linux advised to be backed by transparent huge pages, which saves TLB misses when converting buffers of hundreds of megabytes.
+ *    Whether the kernel grants huge pages is up to its configuration; the buffer works the same either way.
+ */
+enum class buffer_alignment { cache_line, huge_page };
+
+/**
+ * A fixed-size, heap-allocated array of values within numeric_domain<T>, whose first value is aligned as requested.
+ *
+ * Aligned outputs let batch conversions write whole cache lines with streaming stores from the first value (see NUMERIC_DOMAIN_STREAMING_THRESHOLD).
+ * Values are left uninitialized, as with new value_type[count]: buffers are meant to be filled by a conversion, and zeroing them first would cost a pass over memory.
+ * Constructing the buffer allocates (and throws std::bad_alloc on failure); accessing its values never does. Buffers can be moved but not copied.
+ *
+ * For instance, aligned_buffer<float11> floats(count) is filled with domain_cast<float11, int16_t>(samples, samples + count, floats.data()).
+ */
+template <typename T>
+class aligned_buffer {
+public:
+	typedef value_type_of<T> value_type;
+	typedef std::size_t size_type;
+	typedef value_type* iterator;
+	typedef const value_type* const_iterator;
+
+	static constexpr std::size_t cache_line_size = 64;
+	static constexpr std::size_t huge_page_size = std::size_t(2) << 20;
+
+	aligned_buffer() noexcept : values(nullptr), count(0) {}
+	explicit aligned_buffer(const size_type count, const buffer_alignment alignment = buffer_alignment::cache_line) : values(allocate(count, alignment)), count(count) {}
+	aligned_buffer(aligned_buffer&& other) noexcept : values(other.values), count(other.count) {
+		other.values = nullptr;
+		other.count = 0;
+	}
+	aligned_buffer& operator=(aligned_buffer&& other) noexcept {
+		std::swap(values, other.values);
+		std::swap(count, other.count);
+		return *this;
+	}
+	aligned_buffer(const aligned_buffer&) = delete;
+	aligned_buffer& operator=(const aligned_buffer&) = delete;
+	~aligned_buffer() { deallocate(values); }
+
+	size_type size() const noexcept { return count; }
+	bool empty() const noexcept { return count == 0; }
+
+	value_type* data() noexcept { return values; }
+	const value_type* data() const noexcept { return values; }
+	value_type& operator[](const size_type i) noexcept { return values[i]; }
+	const value_type& operator[](const size_type i) const noexcept { return values[i]; }
+
+	iterator begin() noexcept { return values; }
+	iterator end() noexcept { return values + count; }
+	const_iterator begin() const noexcept { return values; }
+	const_iterator end() const noexcept { return values + count; }
+
+private:
+	static value_type* allocate(const size_type count, const buffer_alignment alignment) {
+		if(count == 0) return nullptr;
+		if(count > (std::numeric_limits<std::size_t>::max() - huge_page_size) / sizeof(value_type)) throw std::bad_alloc();
+		const std::size_t boundary = alignment == buffer_alignment::huge_page ? huge_page_size : cache_line_size;
+		// Pad to a multiple of the alignment, so that no other allocation shares the last cache line (or huge page).
+		const std::size_t bytes = (count * sizeof(value_type) + boundary - 1) / boundary * boundary;
+#if defined(_WIN32)
+		void* memory = _aligned_malloc(bytes, boundary);
+		if(!memory) throw std::bad_alloc();
+#else
+		void* memory = nullptr;
+		if(posix_memalign(&memory, boundary, bytes) != 0) throw std::bad_alloc();
+#endif
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+		if(alignment == buffer_alignment::huge_page) {
+			madvise(memory, bytes, MADV_HUGEPAGE); // Only a hint: failing to get huge pages is not an error.
+		}
+#endif
+		return static_cast<value_type*>(memory);
+	}
+
+	static void deallocate(value_type* memory) noexcept {
+#if defined(_WIN32)
+		_aligned_free(memory);
+#else
+		std::free(memory);
+#endif
+	}
+
+	value_type* values;
+	size_type count;
+};
+
+}
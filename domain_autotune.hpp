@@ -0,0 +1,146 @@
+#pragma once
+/**
+ * Startup autotuner picking the fastest conversion strategy for a pair of numeric domains on the host it runs on.
+ * Part of numeric_domain (see numeric_domain.hpp for copyright and license information).
+ */
+
+#include "numeric_domain.hpp"
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace numeric_domain {
+/**
+ * Convert values within numeric_domain<T> to numeric_domain<U> by looking them up in a table.
+ *
+ * Values outside numeric_domain<T> are clamped first, like with domain_cast. The table is owned elsewhere (see domain_autotuner).
+ */
+template <typename U, typename T>
+struct domain_table_caster {
+	const value_type_of<U>* table;
+
+	value_type_of<U> operator()(const value_type_of<T> value) noexcept {
+		return table[bound_value(effective_policy<T, saturate>(), value, numeric_domain<T>::min(), numeric_domain<T>::max()) - numeric_domain<T>::min()];
+	}
+};
+
+/**
+ * Whether values within numeric_domain<T> can be converted with a lookup table, i.e., whether T is an integer domain of at most 16 bits.
+ */
+template <typename T>
+struct is_tabulable : std::integral_constant<bool, std::is_integral<value_type_of<T>>::value && integer_extent<T>::value < 65536> {};
+
+/**
+ * Converts values within numeric_domain<T> to numeric_domain<U> with the strategy found to be the fastest on this host.
+ *
+ * Candidates are the arithmetic conversion of domain_cast (with its compile-time shortcuts), and, for integer source domains of at most 16 bits, a lookup table.
+ * Which one wins depends on the cache sizes and instruction set of the host, so each candidate is timed when the tuner is constructed.
+ * When a cache file is given, the decision is read from it if present, and appended to it otherwise, so that later processes skip the measurement.
+ *
+ * Everything is set up by the constructor, which may allocate and touch the file system: construct tuners at startup, not on a real-time thread.
+ * Conversions themselves are noexcept and never allocate.
+ *
+ * For instance, a domain_autotuner<float11, int16_t> tuner("numeric_domain.cache") may convert 16-bit samples with a 256 KiB table on hosts with a large enough cache, and with multiply-adds elsewhere.
+ */
+template <typename U, typename T>
+class domain_autotuner {
+public:
+	enum class strategy { arithmetic, table };
+
+	explicit domain_autotuner(const char* cache_path = nullptr) : chosen(strategy::arithmetic) {
+		tune(cache_path, is_tabulable<T>());
+	}
+
+	strategy selected() const noexcept { return chosen; }
+
+	value_type_of<U> operator()(const value_type_of<T> value) const noexcept {
+		return convert(chosen, value, is_tabulable<T>());
+	}
+
+	/**
+	 * Convert the contiguous values in [first, last), writing the results to out. Returns the end of the output range.
+	 */
+	value_type_of<U>* operator()(const value_type_of<T>* first, const value_type_of<T>* last, value_type_of<U>* out) const noexcept {
+		return convert(chosen, first, last, out, is_tabulable<T>());
+	}
+
+private:
+	void tune(const char* cache_path, std::true_type) {
+		table.resize(integer_extent<T>::value + 1);
+		for(std::size_t i = 0; i < table.size(); ++i) {
+			table[i] = domain_cast<U,T>(static_cast<value_type_of<T>>(numeric_domain<T>::min() + static_cast<long>(i)));
+		}
+		const std::string key = typeid(domain_caster<U,T>).name();
+		if(cache_path && read(cache_path, key)) return;
+		chosen = measure();
+		if(cache_path) {
+			std::ofstream(cache_path, std::ios::app) << key << ' ' << name(chosen) << '\n';
+		}
+	}
+	// There is nothing to choose from for other domains.
+	void tune(const char*, std::false_type) {}
+
+	value_type_of<U> convert(const strategy s, const value_type_of<T> value, std::true_type) const noexcept {
+		return s == strategy::table ? domain_table_caster<U,T>{table.data()}(value) : domain_caster<U,T>()(value);
+	}
+	value_type_of<U> convert(const strategy, const value_type_of<T> value, std::false_type) const noexcept {
+		return domain_caster<U,T>()(value);
+	}
+	value_type_of<U>* convert(const strategy s, const value_type_of<T>* first, const value_type_of<T>* last, value_type_of<U>* out, std::true_type) const noexcept {
+		if(s == strategy::table) return domain_transform(first, last, out, domain_table_caster<U,T>{table.data()});
+		return domain_transform(first, last, out, domain_caster<U,T>());
+	}
+	value_type_of<U>* convert(const strategy, const value_type_of<T>* first, const value_type_of<T>* last, value_type_of<U>* out, std::false_type) const noexcept {
+		return domain_transform(first, last, out, domain_caster<U,T>());
+	}
+
+	static const char* name(const strategy s) noexcept { return s == strategy::table ? "table" : "arithmetic"; }
+
+	bool read(const char* cache_path, const std::string& key) {
+		std::ifstream file(cache_path);
+		std::string k, s;
+		while(file >> k >> s) {
+			if(k != key) continue;
+			chosen = s == name(strategy::table) ? strategy::table : strategy::arithmetic;
+			return true;
+		}
+		return false;
+	}
+
+	// Time each candidate on pseudo-random values spread over numeric_domain<T>, keeping the best of a few runs to filter out noise.
+	strategy measure() const {
+		std::vector<value_type_of<T>> values(4096);
+		std::vector<value_type_of<U>> out(values.size());
+		// Writing through a volatile pointer keeps the compiler from discarding conversions whose results are never read.
+		value_type_of<U>* volatile destination = out.data();
+		std::uint32_t seed = 12345;
+		for(value_type_of<T>& v : values) {
+			seed = seed * 1664525u + 1013904223u;
+			v = static_cast<value_type_of<T>>(numeric_domain<T>::min() + static_cast<long>((seed >> 8) % (integer_extent<T>::value + 1)));
+		}
+		const strategy candidates[] = { strategy::arithmetic, strategy::table };
+		strategy best = strategy::arithmetic;
+		std::chrono::steady_clock::duration best_time = std::chrono::steady_clock::duration::max();
+		for(const strategy s : candidates) {
+			for(int run = 0; run < 5; ++run) {
+				const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+				for(int pass = 0; pass < 16; ++pass) {
+					convert(s, values.data(), values.data() + values.size(), destination, std::true_type());
+				}
+				const std::chrono::steady_clock::duration time = std::chrono::steady_clock::now() - start;
+				if(time < best_time) {
+					best_time = time;
+					best = s;
+				}
+			}
+		}
+		return best;
+	}
+
+	strategy chosen;
+	std::vector<value_type_of<U>> table;
+};
+
+}
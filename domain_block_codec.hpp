@@ -0,0 +1,236 @@
+#pragma once
+/**
+ * Block floating-point codec, compressing floats by quantizing blocks of them within their own dynamic domain.
+ * Part of numeric_domain (see numeric_domain.hpp for copyright and license information).
+ */
+
+#include "numeric_domain.hpp"
+#include "domain_byte_order.hpp"
+
+namespace numeric_domain {
+/**
+ * Encodes floats by blocks of BlockSize values, each quantized to Bits bits (from 1 to 16) within the range of the block.
+ *
+ * Each encoded block starts with a header holding the minimum and maximum of its values (as floats), which make up its dynamic_domain.
+ * Values are then converted from this domain to unsigned_int<Bits> (from the minimum of the block, so that blocks far from zero keep their precision), rounded to the nearest code, clamped to Bits bits, and bit-packed, least significant bits first.
+ * Decoding converts codes back from unsigned_int<Bits> to the domain of the block, so that every decoded value lies within half a step, (max - min) / (2^Bits - 1) / 2, of the encoded one (plus float rounding).
+ * Blocks whose values are all equal decode exactly.
+ *
+ * Every block takes block_bytes bytes, the last one included (padded with zero codes): block i of an encoded buffer starts at i * block_bytes, so blocks can be decoded in any order.
+ * The encoded format does not depend on the host: bits and headers are stored in little-endian byte order.
+ * For instance, block_codec<8> stores 64 floats in 72 bytes (3.6 times smaller), and block_codec<4, 256> stores 256 floats in 136 bytes (7.5 times smaller).
+ *
+ * Conversions go through domain_coefficients (a clamp and a multiply-add, vectorized like domain_transform), computed with floats, or with doubles for blocks whose step or spread a float cannot hold (tiny spreads, or spreads beyond FLT_MAX).
+ * 8-bit and 16-bit codes are copied by vectorized loops, and other sizes are packed and unpacked 32 bits at a time.
+ * Nothing allocates: blocks are staged on the stack. Values must be finite.
+ */
+template <unsigned Bits, std::size_t BlockSize = 64>
+struct block_codec {
+	static_assert(Bits >= 1 && Bits <= 16, "block_codec quantizes values to 1 to 16 bits");
+	static_assert(BlockSize >= 1, "blocks must hold at least one value");
+
+	typedef unsigned_int<Bits> code_tag;
+	typedef value_type_of<code_tag> code_type;
+
+	static constexpr std::size_t block_size = BlockSize;
+	static constexpr std::size_t header_bytes = 2 * sizeof(float);
+	static constexpr std::size_t payload_bytes = (BlockSize * Bits + 7) / 8;
+	static constexpr std::size_t block_bytes = header_bytes + payload_bytes;
+
+	/**
+	 * The number of blocks, and bytes, taken by count encoded values.
+	 */
+	static constexpr std::size_t blocks(const std::size_t count) noexcept {
+		return (count + BlockSize - 1) / BlockSize;
+	}
+	static constexpr std::size_t encoded_bytes(const std::size_t count) noexcept {
+		return blocks(count) * block_bytes;
+	}
+
+	/**
+	 * Encode the contiguous values in [first, last), writing encoded_bytes(last - first) bytes to out. Returns the end of the output.
+	 */
+	static unsigned char* encode(const float* first, const float* last, unsigned char* out) noexcept {
+		for(; last - first > static_cast<std::ptrdiff_t>(BlockSize); first += BlockSize, out += block_bytes) {
+			encode_block(first, BlockSize, out);
+		}
+		if(first != last) {
+			encode_block(first, static_cast<std::size_t>(last - first), out);
+			out += block_bytes;
+		}
+		return out;
+	}
+
+	/**
+	 * Decode count values from the encoded bytes at in, writing them to out. Returns the end of the output range.
+	 */
+	static float* decode(const unsigned char* in, std::size_t count, float* out) noexcept {
+		for(; count > BlockSize; count -= BlockSize, in += block_bytes, out += BlockSize) {
+			decode_block(in, BlockSize, out);
+		}
+		if(count) decode_block(in, count, out);
+		return out + count;
+	}
+
+	/**
+	 * Encode count values (at most BlockSize) as one block, writing block_bytes bytes to block.
+	 */
+	static void encode_block(const float* values, const std::size_t count, unsigned char* block) noexcept {
+		float low = count ? values[0] : 0.0f;
+		float high = low;
+		for(std::size_t i = 1; i < count; ++i) {
+			low = values[i] < low ? values[i] : low;
+			high = values[i] > high ? values[i] : high;
+		}
+		store(block, low);
+		store(block + sizeof(float), high);
+
+		code_type codes[BlockSize] = {};
+		if(high > low) {
+			if(float_coefficients(low, high)) quantize(values, count, codes, make_domain(low, high));
+			else quantize(values, count, codes, make_domain<double>(low, high));
+			// Rounding may not push codes beyond Bits bits, which would spill into the next codes once packed.
+			for(std::size_t i = 0; i < count; ++i) {
+				codes[i] = bound_value(saturate(), codes[i], numeric_domain<code_tag>::min(), numeric_domain<code_tag>::max());
+			}
+		}
+		pack(codes, block + header_bytes);
+	}
+
+	/**
+	 * Decode the first count values (at most BlockSize) of a block, writing them to out.
+	 */
+	static void decode_block(const unsigned char* block, const std::size_t count, float* out) noexcept {
+		code_type codes[BlockSize];
+		unpack(block + header_bytes, codes);
+		const dynamic_domain<float> range = domain(block);
+		if(float_coefficients(range.min, range.max)) domain_transform(static_cast<const code_type*>(codes), codes + count, out, make_coefficients(range, make_domain<code_tag>()));
+		else domain_transform(static_cast<const code_type*>(codes), codes + count, out, make_coefficients(make_domain<double>(range.min, range.max), make_domain<code_tag>()));
+	}
+
+	/**
+	 * The encoded block holding value index, which can be decoded on its own with decode_block.
+	 */
+	static const unsigned char* block(const unsigned char* encoded, const std::size_t index) noexcept {
+		return encoded + index / BlockSize * block_bytes;
+	}
+
+	/**
+	 * The dynamic domain of the values of an encoded block, e.g. to find the peak of a signal without decoding its values.
+	 */
+	static dynamic_domain<float> domain(const unsigned char* block) noexcept {
+		return make_domain(load(block), load(block + sizeof(float)));
+	}
+
+private:
+	/**
+	 * Whether the coefficients of a block from low to high can be computed with floats: its spread must be finite, and its step, (high - low) / (2^Bits - 1), a normal float, so that its inverse is finite too.
+	 * Other blocks (with spreads below FLT_MIN * (2^Bits - 1), or above FLT_MAX) are converted with doubles, which hold both.
+	 */
+	static bool float_coefficients(const float low, const float high) noexcept {
+		const float spread = high - low;
+		return spread == 0 || (spread <= std::numeric_limits<float>::max() && spread / static_cast<float>(numeric_domain<code_tag>::max()) >= std::numeric_limits<float>::min());
+	}
+
+	/**
+	 * Convert values from the dynamic domain of their block to codes: truncating (value - low) * scale + 1/2 rounds to the nearest code.
+	 */
+	template <typename DynamicDomain>
+	static void quantize(const float* values, const std::size_t count, code_type* codes, const DynamicDomain range) noexcept {
+		auto coefficients = make_coefficients(make_domain<code_tag>(), range);
+		coefficients.origin += 0.5f;
+		domain_transform(values, values + count, codes, coefficients);
+	}
+
+	static void store_bits(unsigned char* out, const std::uint32_t bits) noexcept {
+		const std::uint32_t little = big_endian_host ? swap_bytes(bits) : bits;
+		std::memcpy(out, &little, sizeof(little));
+	}
+	static std::uint32_t load_bits(const unsigned char* in) noexcept {
+		std::uint32_t little;
+		std::memcpy(&little, in, sizeof(little));
+		return big_endian_host ? swap_bytes(little) : little;
+	}
+	static void store(unsigned char* out, const float value) noexcept {
+		std::uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		store_bits(out, bits);
+	}
+	static float load(const unsigned char* in) noexcept {
+		const std::uint32_t bits = load_bits(in);
+		float value;
+		std::memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+
+	/**
+	 * Pack BlockSize codes of Bits bits into payload_bytes bytes.
+	 * Whole bytes (8 or 16 bits) are copied by a loop the compiler vectorizes; other sizes go through a 64-bit accumulator flushed 32 bits at a time.
+	 */
+	static void pack(const code_type* codes, unsigned char* out) noexcept {
+		pack(codes, out, std::integral_constant<bool, Bits % 8 == 0>());
+	}
+	static void pack(const code_type* codes, unsigned char* out, std::true_type /* whole bytes */) noexcept {
+		for(std::size_t i = 0; i < BlockSize; ++i) {
+			for(unsigned byte = 0; byte < Bits / 8; ++byte) {
+				out[i * (Bits / 8) + byte] = static_cast<unsigned char>(codes[i] >> (8 * byte));
+			}
+		}
+	}
+	static void pack(const code_type* codes, unsigned char* out, std::false_type /* whole bytes */) noexcept {
+		std::uint64_t bits = 0;
+		unsigned filled = 0;
+		for(std::size_t i = 0; i < BlockSize; ++i) {
+			bits |= static_cast<std::uint64_t>(codes[i]) << filled;
+			filled += Bits;
+			if(filled >= 32) {
+				store_bits(out, static_cast<std::uint32_t>(bits));
+				out += 4;
+				bits >>= 32;
+				filled -= 32;
+			}
+		}
+		for(; filled > 0; filled = filled > 8 ? filled - 8 : 0, bits >>= 8) {
+			*out++ = static_cast<unsigned char>(bits);
+		}
+	}
+
+	/**
+	 * Unpack BlockSize codes of Bits bits from payload_bytes bytes, like pack: whole bytes are copied, and other sizes go through a 64-bit accumulator refilled 32 bits at a time (byte by byte at the end, so as not to read past the block).
+	 */
+	static void unpack(const unsigned char* in, code_type* codes) noexcept {
+		unpack(in, codes, std::integral_constant<bool, Bits % 8 == 0>());
+	}
+	static void unpack(const unsigned char* in, code_type* codes, std::true_type /* whole bytes */) noexcept {
+		for(std::size_t i = 0; i < BlockSize; ++i) {
+			code_type code = 0;
+			for(unsigned byte = 0; byte < Bits / 8; ++byte) {
+				code |= static_cast<code_type>(in[i * (Bits / 8) + byte]) << (8 * byte);
+			}
+			codes[i] = code;
+		}
+	}
+	static void unpack(const unsigned char* in, code_type* codes, std::false_type /* whole bytes */) noexcept {
+		const unsigned char* const end = in + payload_bytes;
+		std::uint64_t bits = 0;
+		unsigned filled = 0;
+		for(std::size_t i = 0; i < BlockSize; ++i) {
+			if(filled < Bits) {
+				if(end - in >= 4) {
+					bits |= static_cast<std::uint64_t>(load_bits(in)) << filled;
+					in += 4;
+					filled += 32;
+				} else {
+					for(; in != end; ++in, filled += 8) {
+						bits |= static_cast<std::uint64_t>(*in) << filled;
+					}
+				}
+			}
+			codes[i] = static_cast<code_type>(bits & ((std::uint64_t(1) << Bits) - 1));
+			bits >>= Bits;
+			filled -= Bits;
+		}
+	}
+};
+
+}
@@ -0,0 +1,124 @@
+#pragma once
+/**
+ * Conversions reading values directly from (possibly unaligned and byte-swapped) bytes, such as network packets and file records.
+ * Part of numeric_domain (see numeric_domain.hpp for copyright and license information).
+ */
+
+#include "numeric_domain.hpp"
+
+namespace numeric_domain {
+/**
+ * Tags for values within numeric_domain<T>, stored as a Stored in big-endian or little-endian byte order, at any address (aligned or not).
+ *
+ * Stored defaults to the smallest type holding numeric_domain<T> (see compact_type), e.g. a 16-bit field for unsigned_int<12>.
+ * These tags only describe sources, read from bytes by the domain_cast overloads below: they have no numeric_domain of their own.
+ */
+template <typename T, typename Stored = typename compact_type<T>::type>
+struct big_endian {};
+template <typename T, typename Stored = typename compact_type<T>::type>
+struct little_endian {};
+
+/**
+ * Whether the host stores values in big-endian byte order.
+ */
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+constexpr bool big_endian_host = true;
+#else
+constexpr bool big_endian_host = false;
+#endif
+
+/**
+ * Reverse the order of the bytes of an unsigned integer. Compilers turn these into a single instruction (bswap, rev), and vectorize them into byte shuffles.
+ */
+constexpr std::uint8_t swap_bytes(const std::uint8_t value) noexcept {
+	return value;
+}
+constexpr std::uint16_t swap_bytes(const std::uint16_t value) noexcept {
+	return static_cast<std::uint16_t>(value >> 8 | value << 8);
+}
+constexpr std::uint32_t swap_bytes(const std::uint32_t value) noexcept {
+	return value >> 24 | (value >> 8 & 0xff00u) | (value << 8 & 0xff0000u) | value << 24;
+}
+constexpr std::uint64_t swap_bytes(const std::uint64_t value) noexcept {
+	return static_cast<std::uint64_t>(swap_bytes(static_cast<std::uint32_t>(value))) << 32 | swap_bytes(static_cast<std::uint32_t>(value >> 32));
+}
+
+/**
+ * How a tag describing stored bytes is read: the tag of the values, the stored type, and whether its bytes are swapped on this host.
+ */
+template <typename Tag>
+struct byte_order_traits;
+template <typename T, typename Stored>
+struct byte_order_traits<big_endian<T, Stored>> {
+	typedef T tag;
+	typedef Stored stored_type;
+	static constexpr bool swapped = !big_endian_host && sizeof(Stored) > 1;
+};
+template <typename T, typename Stored>
+struct byte_order_traits<little_endian<T, Stored>> {
+	typedef T tag;
+	typedef Stored stored_type;
+	static constexpr bool swapped = big_endian_host && sizeof(Stored) > 1;
+};
+
+/**
+ * The unsigned integer type of the same size as T.
+ */
+template <std::size_t Size> struct unsigned_of_size;
+template <> struct unsigned_of_size<1> { typedef std::uint8_t type; };
+template <> struct unsigned_of_size<2> { typedef std::uint16_t type; };
+template <> struct unsigned_of_size<4> { typedef std::uint32_t type; };
+template <> struct unsigned_of_size<8> { typedef std::uint64_t type; };
+
+/**
+ * Read a value stored with the byte order of Tag from bytes, which need not be aligned.
+ *
+ * Bytes are read with memcpy, which compilers turn into a plain (unaligned) load, so it is as cheap as dereferencing a pointer, without breaking alignment or strict aliasing rules.
+ */
+template <typename Tag>
+value_type_of<typename byte_order_traits<Tag>::tag> load_stored(const unsigned char* bytes) noexcept {
+	typedef typename byte_order_traits<Tag>::stored_type stored_type;
+	typedef typename unsigned_of_size<sizeof(stored_type)>::type bits_type;
+	bits_type bits;
+	std::memcpy(&bits, bytes, sizeof(bits));
+	if(byte_order_traits<Tag>::swapped) bits = swap_bytes(bits);
+	stored_type stored;
+	std::memcpy(&stored, &bits, sizeof(stored));
+	return static_cast<value_type_of<typename byte_order_traits<Tag>::tag>>(stored);
+}
+
+/**
+ * Convert a value within numeric_domain<T>, stored as described by a byte-order tag (big_endian<T> or little_endian<T>) at an address which need not be aligned, to numeric_domain<U>.
+ *
+ * For instance, domain_cast<float01, big_endian<unsigned_int<12>>>(packet + 6) reads the 16-bit big-endian field at offset 6 of a packet, and converts it from 12 bits to a float between 0 and 1.
+ */
+template <typename U, typename Tag, typename Policy = saturate, typename = typename byte_order_traits<Tag>::tag>
+value_type_of<U> domain_cast(const void* bytes) noexcept {
+	return domain_caster<U, typename byte_order_traits<Tag>::tag, Policy>()(load_stored<Tag>(static_cast<const unsigned char*>(bytes)));
+}
+
+/**
+ * Convert count values within numeric_domain<T>, stored as described by a byte-order tag from bytes onwards, to numeric_domain<U>, writing the results to out.
+ * Returns the end of the output range.
+ *
+ * Values are stride bytes apart (by default, packed one after the other), e.g. the size of a record for a field repeated in each record of a file.
+ * Reading, swapping and converting are fused into one loop, which compilers vectorize (with byte shuffles for the swap) when values are packed; strided values are gathered one by one.
+ */
+template <typename U, typename Tag, typename Policy = saturate, typename = typename byte_order_traits<Tag>::tag>
+value_type_of<U>* domain_cast(const void* bytes, const std::size_t count, value_type_of<U>* out, const std::ptrdiff_t stride = sizeof(typename byte_order_traits<Tag>::stored_type)) noexcept {
+	typedef typename byte_order_traits<Tag>::stored_type stored_type;
+	const domain_caster<U, typename byte_order_traits<Tag>::tag, Policy> caster;
+	const unsigned char* in = static_cast<const unsigned char*>(bytes);
+	if(stride == static_cast<std::ptrdiff_t>(sizeof(stored_type))) {
+		for(std::size_t i = 0; i < count; ++i) {
+			out[i] = caster(load_stored<Tag>(in + i * sizeof(stored_type)));
+		}
+	} else {
+		for(std::size_t i = 0; i < count; ++i) {
+			out[i] = caster(load_stored<Tag>(in + static_cast<std::ptrdiff_t>(i) * stride));
+		}
+	}
+	return out + count;
+}
+
+}
@@ -0,0 +1,123 @@
+#pragma once
+/**
+ * Scopes flushing subnormal floating-point numbers to zero while converting.
+ * Part of numeric_domain (see numeric_domain.hpp for copyright and license information).
+ */
+
+#include "numeric_domain.hpp"
+#if defined(NUMERIC_DOMAIN_SSE2)
+#include <xmmintrin.h>
+#elif defined(_M_ARM64)
+#include <intrin.h>
+#endif
+
+namespace numeric_domain {
+/**
+ * Flushes subnormal numbers to zero on the current thread for as long as it exists, then restores the floating-point environment of the caller.
+ *
+ * Subnormal (denormal) numbers are those smaller in magnitude than std::numeric_limits<float>::min(), e.g. when converting to a domain of tiny extent or from values close to zero.
+ * Most CPUs compute with them in microcode, at a cost of about a hundred cycles per operation. Within the scope, they are treated as zero when read and written as zero when produced, which costs nothing, at the price of their precision.
+ *
+ * On x86, this sets the flush-to-zero (FTZ) and denormals-are-zero (DAZ) bits of MXCSR; on ARM, the flush-to-zero (FZ) bit of FPCR (or FPSCR).
+ * Elsewhere, it does nothing (see supported).
+ * Reading and writing the control register neither allocates nor calls into the operating system, so scopes can be opened on real-time threads, e.g. around each audio block.
+ *
+ * Only the current thread is affected. Scopes nest: each one restores the environment it found.
+ */
+class denormals_flushed {
+public:
+#if defined(NUMERIC_DOMAIN_SSE2) || defined(__aarch64__) || defined(_M_ARM64) || (defined(__arm__) && defined(__ARM_FP))
+	static constexpr bool supported = true;
+#else
+	static constexpr bool supported = false;
+#endif
+
+	denormals_flushed() noexcept : saved(get()) {
+		set(saved | flags);
+		barrier();
+	}
+	~denormals_flushed() {
+		barrier();
+		set(saved);
+	}
+	denormals_flushed(const denormals_flushed&) = delete;
+	denormals_flushed& operator=(const denormals_flushed&) = delete;
+
+private:
+#if defined(NUMERIC_DOMAIN_SSE2)
+	typedef unsigned int control_type;
+	static constexpr control_type flags = 0x8040; // FTZ (bit 15) and DAZ (bit 6)
+	static control_type get() noexcept { return _mm_getcsr(); }
+	static void set(const control_type control) noexcept { _mm_setcsr(control); }
+#elif defined(__aarch64__) && defined(__GNUC__)
+	typedef std::uint64_t control_type;
+	static constexpr control_type flags = control_type(1) << 24; // FZ
+	static control_type get() noexcept { control_type control; __asm__ __volatile__("mrs %0, fpcr" : "=r"(control)); return control; }
+	static void set(const control_type control) noexcept { __asm__ __volatile__("msr fpcr, %0" : : "r"(control)); }
+#elif defined(_M_ARM64)
+	typedef unsigned __int64 control_type;
+	static constexpr control_type flags = control_type(1) << 24; // FZ
+	static control_type get() noexcept { return _ReadStatusReg(ARM64_FPCR); }
+	static void set(const control_type control) noexcept { _WriteStatusReg(ARM64_FPCR, control); }
+#elif defined(__arm__) && defined(__ARM_FP) && defined(__GNUC__)
+	typedef std::uint32_t control_type;
+	static constexpr control_type flags = control_type(1) << 24; // FZ
+	static control_type get() noexcept { control_type control; __asm__ __volatile__("vmrs %0, fpscr" : "=r"(control)); return control; }
+	static void set(const control_type control) noexcept { __asm__ __volatile__("vmsr fpscr, %0" : : "r"(control)); }
+#else
+	typedef unsigned int control_type;
+	static constexpr control_type flags = 0;
+	static control_type get() noexcept { return 0; }
+	static void set(control_type) noexcept {}
+#endif
+
+	/**
+	 * The compiler does not know that arithmetic depends on the floating-point environment: keep it from moving loads and stores of values across changes of the environment.
+	 */
+	static void barrier() noexcept {
+#if defined(__GNUC__)
+		__asm__ __volatile__("" : : : "memory");
+#endif
+	}
+
+	const control_type saved;
+};
+
+/**
+ * Batch conversions taking flush_denormals() as their last argument are computed within a denormals_flushed scope.
+ */
+struct flush_denormals {};
+
+/**
+ * Convert the contiguous values in [first, last) with the given caster, writing the results to out, with subnormal numbers flushed to zero.
+ * Returns the end of the output range.
+ */
+template <typename T, typename U, typename Caster>
+U* domain_transform(const T* first, const T* last, U* out, Caster caster, flush_denormals) noexcept {
+	const denormals_flushed scope;
+#if defined(__GNUC__)
+	// Values the compiler knows of (e.g. constant arrays) would otherwise be converted at compile time, without flushing.
+	__asm__ __volatile__("" : "+r"(first), "+r"(out));
+#endif
+	return domain_transform(first, last, out, caster);
+}
+
+/**
+ * Convert the contiguous values in [first, last) within numeric_domain<T> to numeric_domain<U>, writing the results to out, with subnormal numbers flushed to zero.
+ * Returns the end of the output range.
+ */
+template <typename U, typename T, typename Policy = saturate>
+value_type_of<U>* domain_cast(const value_type_of<T>* first, const value_type_of<T>* last, value_type_of<U>* out, flush_denormals) noexcept {
+	return domain_transform(first, last, out, domain_caster<U,T,Policy>(), flush_denormals());
+}
+
+/**
+ * Convert the contiguous values in [first, last) within a given dynamic domain to another, writing the results to out, with subnormal numbers flushed to zero.
+ * Returns the end of the output range.
+ */
+template <typename DynamicDomainTo, typename DynamicDomainFrom>
+typename DynamicDomainTo::value_type* domain_cast(const DynamicDomainTo to, const typename DynamicDomainFrom::value_type* first, const typename DynamicDomainFrom::value_type* last, typename DynamicDomainTo::value_type* out, const DynamicDomainFrom from, flush_denormals) noexcept {
+	return domain_transform(first, last, out, make_caster(to, from), flush_denormals());
+}
+
+}
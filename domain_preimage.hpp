@@ -0,0 +1,150 @@
+#pragma once
+/**
+ * Predicate pushdown: turn ranges of converted values into ranges of source values, and filter source values without converting them.
+ * Part of numeric_domain (see numeric_domain.hpp for copyright and license information).
+ */
+
+#include "numeric_domain.hpp"
+#include <cstring>
+
+namespace numeric_domain {
+/**
+ * An inclusive range [first, last] of values of type V. It is empty when first > last.
+ */
+template <typename V>
+struct value_range {
+	V first;
+	V last;
+
+	bool empty() const noexcept { return !(first <= last); }
+	bool contains(const V value) const noexcept { return value >= first && value <= last; }
+};
+
+/**
+ * A bijection between the (non-NaN) values of V and an interval of 64-bit unsigned keys, which preserves their order.
+ * Integers are offset by their lowest value, and floating-point numbers are ordered through their bit pattern (negative numbers have their bits inverted).
+ */
+template <typename V, typename = void>
+struct ordered_key {};
+template <typename V>
+struct ordered_key<V, typename std::enable_if<std::is_integral<V>::value>::type> {
+	static V lowest() noexcept { return std::numeric_limits<V>::lowest(); }
+	static V highest() noexcept { return std::numeric_limits<V>::max(); }
+	static std::uint64_t of(const V value) noexcept { return static_cast<std::uintmax_t>(value) - static_cast<std::uintmax_t>(lowest()); }
+	static V value(const std::uint64_t key) noexcept { return static_cast<V>(static_cast<std::uintmax_t>(lowest()) + key); }
+};
+template <typename V>
+struct ordered_key<V, typename std::enable_if<std::is_floating_point<V>::value>::type> {
+	static_assert(sizeof(V) == 4 || sizeof(V) == 8, "ordered keys are only defined for 32-bit and 64-bit floating-point numbers");
+	typedef typename std::conditional<sizeof(V) == 4, std::uint32_t, std::uint64_t>::type bits_type;
+	static constexpr bits_type sign = static_cast<bits_type>(1) << (sizeof(V) * 8 - 1);
+
+	static V lowest() noexcept { return -std::numeric_limits<V>::infinity(); }
+	static V highest() noexcept { return std::numeric_limits<V>::infinity(); }
+	static std::uint64_t of(const V value) noexcept {
+		bits_type bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		return static_cast<bits_type>(bits & sign ? ~bits : bits | sign);
+	}
+	static V value(const std::uint64_t key) noexcept {
+		bits_type bits = static_cast<bits_type>(key);
+		bits = bits & sign ? bits & ~sign : ~bits;
+		V result;
+		std::memcpy(&result, &bits, sizeof(result));
+		return result;
+	}
+};
+
+/**
+ * Find the smallest key in [low, high] whose value satisfies predicate, which must be false then true along keys. Returns false if there is none.
+ */
+template <typename V, typename Predicate>
+bool first_key(std::uint64_t low, std::uint64_t high, Predicate predicate, std::uint64_t& key) noexcept {
+	if(!predicate(ordered_key<V>::value(high))) return false;
+	while(low < high) {
+		const std::uint64_t middle = low + (high - low) / 2;
+		if(predicate(ordered_key<V>::value(middle))) {
+			high = middle;
+		} else {
+			low = middle + 1;
+		}
+	}
+	key = low;
+	return true;
+}
+
+/**
+ * The range of source values which the given caster converts to values within [low, high].
+ *
+ * The conversion must be monotonic (either non-decreasing or non-increasing), which domain casts are when values are saturated.
+ * Bounds are found by binary search over every value of the source type (including those outside the source domain, which are clamped to its bounds before conversion), so they are exact whatever the rounding of the conversion: about 64 conversions are made.
+ * NaN source values are never within the returned range.
+ */
+template <typename V, typename W, typename Caster>
+value_range<V> preimage(Caster caster, const W low, const W high) noexcept {
+	typedef ordered_key<V> key;
+	const std::uint64_t lowest = key::of(key::lowest());
+	const std::uint64_t highest = key::of(key::highest());
+	const bool increasing = !(caster(key::highest()) < caster(key::lowest()));
+	const value_range<V> none = { key::highest(), key::lowest() };
+
+	// First source value converted to something within [low, high], then first one converted beyond it.
+	std::uint64_t first;
+	if(!first_key<V>(lowest, highest, [&](const V v) { return increasing ? !(caster(v) < low) : !(caster(v) > high); }, first)) return none;
+	std::uint64_t after;
+	if(!first_key<V>(first, highest, [&](const V v) { return increasing ? caster(v) > high : caster(v) < low; }, after)) {
+		return { key::value(first), key::highest() };
+	}
+	if(after == first) return none;
+	return { key::value(first), key::value(after - 1) };
+}
+
+/**
+ * The range of values within numeric_domain<T> which domain_cast<U,T> converts to values within [low, high].
+ *
+ * Filtering source values with this range gives the same result as filtering converted values with [low, high], without converting anything.
+ * For instance, domain_preimage<float01, int16_t>(std::nextafter(0.75f, 1.0f), 1.0f) gives the int16_t samples converted to more than 0.75.
+ */
+template <typename U, typename T>
+value_range<value_type_of<T>> domain_preimage(const value_type_of<U> low, const value_type_of<U> high) noexcept {
+	return preimage<value_type_of<T>>(domain_caster<U,T>(), low, high);
+}
+
+/**
+ * The range of values within a given dynamic domain which are converted to values within [low, high] of another dynamic domain.
+ * Decreasing domains are supported.
+ */
+template <typename DynamicDomainTo, typename DynamicDomainFrom>
+value_range<typename DynamicDomainFrom::value_type> domain_preimage(const DynamicDomainTo to, const typename DynamicDomainTo::value_type low, const typename DynamicDomainTo::value_type high, const DynamicDomainFrom from) noexcept {
+	return preimage<typename DynamicDomainFrom::value_type>(make_caster(to, from), low, high);
+}
+
+/**
+ * Count the values in [first, last) which are within range.
+ *
+ * The loop is branchless, so that the compiler can vectorize it.
+ */
+template <typename V>
+std::size_t count_within(const V* first, const V* last, const value_range<V> range) noexcept {
+	std::size_t count = 0;
+	for(; first != last; ++first) {
+		count += (*first >= range.first) & (*first <= range.last);
+	}
+	return count;
+}
+
+/**
+ * Copy the values in [first, last) which are within range to out, keeping their order. Returns the end of the output range.
+ *
+ * Every value is written and the output only advances past matching ones, so that the loop does not branch on data; out must have room for last - first values.
+ */
+template <typename V>
+V* select_within(const V* first, const V* last, const value_range<V> range, V* out) noexcept {
+	for(; first != last; ++first) {
+		*out = *first;
+		out += (*first >= range.first) & (*first <= range.last);
+	}
+	return out;
+}
+
+}
@@ -0,0 +1,165 @@
+#pragma once
+/**
+ * Container storing values within a narrow numeric domain, and exposing them within a wider one.
+ * Part of numeric_domain (see numeric_domain.hpp for copyright and license information).
+ */
+
+#include "numeric_domain.hpp"
+#include <iterator>
+#include <vector>
+
+namespace numeric_domain {
+/**
+ * A reference to a value of a quantized_array: reading it decodes the stored value from numeric_domain<StorageTag> to numeric_domain<ViewTag>, and assigning to it encodes the new value the other way.
+ * Stored is const for references which can only be read.
+ */
+template <typename StorageTag, typename ViewTag, typename Stored>
+class quantized_reference {
+public:
+	typedef value_type_of<ViewTag> value_type;
+
+	explicit quantized_reference(Stored* stored) noexcept : stored(stored) {}
+
+	operator value_type() const noexcept {
+		return domain_cast<ViewTag, StorageTag>(*stored);
+	}
+
+	quantized_reference& operator=(const value_type value) noexcept {
+		*stored = static_cast<Stored>(domain_cast<StorageTag, ViewTag>(value));
+		return *this;
+	}
+
+	/**
+	 * Copy the stored value of another reference, without decoding and encoding it again (which may not give it back exactly).
+	 */
+	quantized_reference& operator=(const quantized_reference& other) noexcept {
+		*stored = *other.stored;
+		return *this;
+	}
+
+private:
+	Stored* stored;
+};
+
+/**
+ * A random-access iterator over the values of a quantized_array, whose references are quantized_reference proxies (as with std::vector<bool>).
+ */
+template <typename StorageTag, typename ViewTag, typename Stored>
+class quantized_iterator {
+public:
+	typedef std::random_access_iterator_tag iterator_category;
+	typedef value_type_of<ViewTag> value_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef quantized_reference<StorageTag, ViewTag, Stored> reference;
+	typedef void pointer;
+
+	quantized_iterator() noexcept : stored(nullptr) {}
+	explicit quantized_iterator(Stored* stored) noexcept : stored(stored) {}
+	/**
+	 * Mutable iterators convert to constant ones.
+	 */
+	template <typename OtherStored, typename = typename std::enable_if<std::is_convertible<OtherStored*, Stored*>::value>::type>
+	quantized_iterator(const quantized_iterator<StorageTag, ViewTag, OtherStored> other) noexcept : stored(other.base()) {}
+
+	Stored* base() const noexcept { return stored; }
+
+	reference operator*() const noexcept { return reference(stored); }
+	reference operator[](const difference_type n) const noexcept { return reference(stored + n); }
+
+	quantized_iterator& operator++() noexcept { ++stored; return *this; }
+	quantized_iterator& operator--() noexcept { --stored; return *this; }
+	quantized_iterator operator++(int) noexcept { return quantized_iterator(stored++); }
+	quantized_iterator operator--(int) noexcept { return quantized_iterator(stored--); }
+	quantized_iterator& operator+=(const difference_type n) noexcept { stored += n; return *this; }
+	quantized_iterator& operator-=(const difference_type n) noexcept { stored -= n; return *this; }
+	quantized_iterator operator+(const difference_type n) const noexcept { return quantized_iterator(stored + n); }
+	quantized_iterator operator-(const difference_type n) const noexcept { return quantized_iterator(stored - n); }
+	friend quantized_iterator operator+(const difference_type n, const quantized_iterator i) noexcept { return i + n; }
+	difference_type operator-(const quantized_iterator other) const noexcept { return stored - other.stored; }
+
+	bool operator==(const quantized_iterator other) const noexcept { return stored == other.stored; }
+	bool operator!=(const quantized_iterator other) const noexcept { return stored != other.stored; }
+	bool operator<(const quantized_iterator other) const noexcept { return stored < other.stored; }
+	bool operator>(const quantized_iterator other) const noexcept { return stored > other.stored; }
+	bool operator<=(const quantized_iterator other) const noexcept { return stored <= other.stored; }
+	bool operator>=(const quantized_iterator other) const noexcept { return stored >= other.stored; }
+
+private:
+	Stored* stored;
+};
+
+/**
+ * A contiguous array of values within numeric_domain<ViewTag>, stored within numeric_domain<StorageTag>.
+ *
+ * Values are encoded with domain_cast<StorageTag, ViewTag> when written, and decoded with domain_cast<ViewTag, StorageTag> when read, through operator[] and iterators (whose references are proxies) or in bulk with read() and write(), which use the batch kernels.
+ * For instance, a quantized_array<unsigned_int<12>, float01> keeps floats between 0 and 1 with 12 bits of precision in half the memory of a float array, and a quantized_array<uint8_t, float11> in a quarter.
+ *
+ * Values are stored in the smallest integer type which holds numeric_domain<StorageTag> (see compact_type), e.g. in uint16_t for unsigned_int<12>.
+ * Storage is a contiguous container of them (with size(), data() and resize(), and constructible from a count and an optional value), e.g. a std::vector with a custom allocator.
+ * Constructing and resizing the array may allocate; reading and writing values never does.
+ */
+template <typename StorageTag, typename ViewTag, typename Storage = std::vector<typename compact_type<StorageTag>::type>>
+class quantized_array {
+public:
+	typedef value_type_of<ViewTag> value_type;
+	typedef typename Storage::value_type stored_type;
+	typedef std::size_t size_type;
+	typedef quantized_reference<StorageTag, ViewTag, stored_type> reference;
+	typedef quantized_iterator<StorageTag, ViewTag, stored_type> iterator;
+	typedef quantized_iterator<StorageTag, ViewTag, const stored_type> const_iterator;
+
+	quantized_array() = default;
+	/**
+	 * An array of count values, whose stored values are zero.
+	 */
+	explicit quantized_array(const size_type count) : values(count) {}
+	/**
+	 * An array of count copies of value.
+	 */
+	quantized_array(const size_type count, const value_type value) : values(count, static_cast<stored_type>(domain_cast<StorageTag, ViewTag>(value))) {}
+	/**
+	 * An array of the values in [first, last).
+	 */
+	quantized_array(const value_type* first, const value_type* last) : values(static_cast<size_type>(last - first)) {
+		write(0, first, static_cast<size_type>(last - first));
+	}
+
+	size_type size() const noexcept { return values.size(); }
+	bool empty() const noexcept { return values.size() == 0; }
+	void resize(const size_type count) { values.resize(count); }
+
+	reference operator[](const size_type i) noexcept { return reference(values.data() + i); }
+	value_type operator[](const size_type i) const noexcept { return domain_cast<ViewTag, StorageTag>(values.data()[i]); }
+
+	iterator begin() noexcept { return iterator(values.data()); }
+	iterator end() noexcept { return iterator(values.data() + values.size()); }
+	const_iterator begin() const noexcept { return cbegin(); }
+	const_iterator end() const noexcept { return cend(); }
+	const_iterator cbegin() const noexcept { return const_iterator(values.data()); }
+	const_iterator cend() const noexcept { return const_iterator(values.data() + values.size()); }
+
+	/**
+	 * Decode count values starting at index first, writing them to out.
+	 */
+	void read(const size_type first, const size_type count, value_type* out) const noexcept {
+		domain_transform(values.data() + first, values.data() + first + count, out, domain_caster<ViewTag, StorageTag>());
+	}
+
+	/**
+	 * Encode count values from in, storing them starting at index first.
+	 */
+	void write(const size_type first, const value_type* in, const size_type count) noexcept {
+		domain_transform(in, in + count, values.data() + first, domain_caster<StorageTag, ViewTag>());
+	}
+
+	/**
+	 * The stored values, e.g. to serialize them without decoding them.
+	 */
+	stored_type* data() noexcept { return values.data(); }
+	const stored_type* data() const noexcept { return values.data(); }
+
+private:
+	Storage values;
+};
+
+}
@@ -0,0 +1,278 @@
+#pragma once
+/**
+ * Reductions (sum, mean, RMS, peak, dot product) of converted values, computed without writing converted values to memory.
+ * Part of numeric_domain (see numeric_domain.hpp for copyright and license information).
+ */
+
+#include "numeric_domain.hpp"
+
+namespace numeric_domain {
+/**
+ * Sum term(i) for i in [0, count), in 8 independent accumulators of type Lane, which are added to a double every 256 terms.
+ *
+ * The compiler may not reorder floating-point additions (without -ffast-math), so a reduction into a single accumulator waits for the latency of each addition; independent accumulators overlap them (and may be vectorized).
+ * Flushing lanes to a double regularly bounds the error of their sums, so that lanes can be floats.
+ */
+template <typename Lane, typename Term>
+double lane_sum(const std::size_t count, Term term) noexcept {
+	const std::size_t lanes = 8;
+	const std::size_t chunk = 256;
+	double sum = 0;
+	for(std::size_t start = 0; start < count; start += chunk) {
+		const std::size_t end = std::min(count, start + chunk);
+		Lane partial[lanes] = {};
+		std::size_t i = start;
+		for(; i + lanes <= end; i += lanes) {
+			for(std::size_t j = 0; j < lanes; ++j) {
+				partial[j] += term(i + j);
+			}
+		}
+		for(; i < end; ++i) {
+			partial[i % lanes] += term(i);
+		}
+		for(std::size_t j = 0; j < lanes; ++j) {
+			sum += static_cast<double>(partial[j]);
+		}
+	}
+	return sum;
+}
+
+/**
+ * How a reduction of values converted from numeric_domain<T> to numeric_domain<U> is computed, chosen at compile time.
+ *
+ *  - integer_moments: for floating-point domains U and integer domains T within [-65536, 65536] (e.g. int16_t, uint8_t or unsigned_int<12>), bounded source values (and their squares) are summed exactly with 64-bit integers, and the affine map of the conversion is applied to the sums.
+ *  - floating_moments: for other floating-point domains U, bounded source values are summed in double, then mapped.
+ *  - converted: for integer domains U, which round each converted value, values are converted one by one in registers, then summed in double.
+ */
+enum class reduction { integer_moments, floating_moments, converted };
+
+template <typename U, typename T>
+struct reduction_of : std::integral_constant<reduction,
+	!std::is_floating_point<value_type_of<U>>::value ? reduction::converted
+	: std::is_integral<value_type_of<T>>::value && static_cast<std::intmax_t>(numeric_domain<T>::min()) >= -65536 && numeric_domain<T>::max() <= 65536 ? reduction::integer_moments
+	: reduction::floating_moments> {};
+
+/**
+ * The type of the lanes of lane_sum for reductions from numeric_domain<T> to numeric_domain<U>: float, unless either domain needs more precision.
+ */
+template <typename U, typename T>
+using lane_type_of = typename std::common_type<float, value_type_of<U>, value_type_of<T>>::type;
+
+/**
+ * The conversion from numeric_domain<T> to a floating-point numeric_domain<U>, as y = scale() * (x - zero()), computed in double.
+ */
+template <typename U, typename T>
+struct affine_map {
+	static constexpr double scale() noexcept {
+		return (static_cast<double>(numeric_domain<U>::max()) - static_cast<double>(numeric_domain<U>::min())) / (static_cast<double>(numeric_domain<T>::max()) - static_cast<double>(numeric_domain<T>::min()));
+	}
+	static constexpr double zero() noexcept {
+		return static_cast<double>(numeric_domain<T>::min()) - static_cast<double>(numeric_domain<U>::min()) / scale();
+	}
+};
+
+template <typename T, typename Policy>
+value_type_of<T> bounded(const value_type_of<T> value) noexcept {
+	return bound_value(effective_policy<T, Policy>(), value, numeric_domain<T>::min(), numeric_domain<T>::max());
+}
+
+/**
+ * The accumulator of the sums of squares of integer_sums: exact with 128-bit integers, rounded to long double where there are none.
+ */
+#if defined(__SIZEOF_INT128__)
+typedef unsigned __int128 square_sum;
+#else
+typedef long double square_sum;
+#endif
+
+/**
+ * Exact sums of the bounded values of [first, last), and of their squares.
+ *
+ * Values are within [-65536, 65536], so squares are summed with 64-bit integers over runs of 2^31 values (which cannot overflow), then added to a square_sum, like lanes are flushed by lane_sum.
+ * The sum of values itself holds 64 bits for ranges of fewer than 2^47 values (256 TiB of 16-bit samples).
+ */
+template <typename T, typename Policy>
+void integer_sums(const value_type_of<T>* first, const value_type_of<T>* last, std::int64_t& sum, square_sum& squares) noexcept {
+	assert(static_cast<std::uint64_t>(last - first) < std::uint64_t(1) << 47);
+	const std::size_t run = std::size_t(1) << 31;
+	while(first != last) {
+		const value_type_of<T>* const end = first + std::min(static_cast<std::size_t>(last - first), run);
+		std::uint64_t partial = 0;
+		for(; first != end; ++first) {
+			const std::int64_t x = bounded<T, Policy>(*first);
+			sum += x;
+			partial += static_cast<std::uint64_t>(x * x);
+		}
+		squares += partial;
+	}
+}
+
+template <typename U, typename T, typename Policy>
+double domain_sum(const value_type_of<T>* first, const value_type_of<T>* last, std::integral_constant<reduction, reduction::integer_moments>) noexcept {
+	std::int64_t sum = 0;
+	square_sum squares = 0;
+	integer_sums<T, Policy>(first, last, sum, squares);
+	return affine_map<U,T>::scale() * (static_cast<double>(sum) - static_cast<double>(last - first) * affine_map<U,T>::zero());
+}
+template <typename U, typename T, typename Policy>
+double domain_sum(const value_type_of<T>* first, const value_type_of<T>* last, std::integral_constant<reduction, reduction::floating_moments>) noexcept {
+	typedef lane_type_of<U,T> L;
+	const double sum = lane_sum<L>(static_cast<std::size_t>(last - first), [first](const std::size_t i) { return static_cast<L>(bounded<T, Policy>(first[i])); });
+	return affine_map<U,T>::scale() * (sum - static_cast<double>(last - first) * affine_map<U,T>::zero());
+}
+template <typename U, typename T, typename Policy>
+double domain_sum(const value_type_of<T>* first, const value_type_of<T>* last, std::integral_constant<reduction, reduction::converted>) noexcept {
+	return lane_sum<double>(static_cast<std::size_t>(last - first), [first](const std::size_t i) { return static_cast<double>(domain_cast<U, T, Policy>(first[i])); });
+}
+
+template <typename U, typename T, typename Policy>
+double domain_rms(const value_type_of<T>* first, const value_type_of<T>* last, std::integral_constant<reduction, reduction::integer_moments>) noexcept {
+	std::int64_t sum = 0;
+	square_sum squares = 0;
+	integer_sums<T, Policy>(first, last, sum, squares);
+	const std::uint64_t n = static_cast<std::uint64_t>(last - first);
+	// sum((x - zero)^2) = (n * squares - sum^2) / n + n * (mean - zero)^2, where the first term (n times the variance) is computed exactly (with 128-bit integers), so that nothing cancels out.
+	// Below 2^47 values, squares < 2^79 and n * squares < 2^126.
+#if defined(__SIZEOF_INT128__)
+	const double spread = static_cast<double>(static_cast<unsigned __int128>(n) * squares - static_cast<unsigned __int128>(static_cast<__int128>(sum) * sum));
+#else
+	const double spread = static_cast<double>(static_cast<long double>(n) * squares - static_cast<long double>(sum) * sum);
+#endif
+	const double mean = static_cast<double>(sum) / static_cast<double>(n);
+	const double deviation = mean - affine_map<U,T>::zero();
+	return std::fabs(affine_map<U,T>::scale()) * std::sqrt(spread / (static_cast<double>(n) * static_cast<double>(n)) + deviation * deviation);
+}
+template <typename U, typename T, typename Policy>
+double domain_rms(const value_type_of<T>* first, const value_type_of<T>* last, std::integral_constant<reduction, reduction::floating_moments>) noexcept {
+	typedef lane_type_of<U,T> L;
+	const double squares = lane_sum<L>(static_cast<std::size_t>(last - first), [first](const std::size_t i) {
+		const L x = static_cast<L>(bounded<T, Policy>(first[i])) - static_cast<L>(affine_map<U,T>::zero());
+		return x * x;
+	});
+	return std::fabs(affine_map<U,T>::scale()) * std::sqrt(squares / static_cast<double>(last - first));
+}
+template <typename U, typename T, typename Policy>
+double domain_rms(const value_type_of<T>* first, const value_type_of<T>* last, std::integral_constant<reduction, reduction::converted>) noexcept {
+	const double squares = lane_sum<double>(static_cast<std::size_t>(last - first), [first](const std::size_t i) {
+		const double y = static_cast<double>(domain_cast<U, T, Policy>(first[i]));
+		return y * y;
+	});
+	return std::sqrt(squares / static_cast<double>(last - first));
+}
+
+template <typename U, typename T, typename Policy>
+double mapped_dot(const value_type_of<T>* first, const value_type_of<T>* last, const value_type_of<U>* other) noexcept {
+	// sum(y * other) = scale * sum((x - zero) * other)
+	typedef lane_type_of<U,T> L;
+	return affine_map<U,T>::scale() * lane_sum<L>(static_cast<std::size_t>(last - first), [first, other](const std::size_t i) {
+		return (static_cast<L>(bounded<T, Policy>(first[i])) - static_cast<L>(affine_map<U,T>::zero())) * static_cast<L>(other[i]);
+	});
+}
+template <typename U, typename T, typename Policy>
+double domain_dot(const value_type_of<T>* first, const value_type_of<T>* last, const value_type_of<U>* other, std::integral_constant<reduction, reduction::integer_moments>) noexcept {
+	return mapped_dot<U, T, Policy>(first, last, other);
+}
+template <typename U, typename T, typename Policy>
+double domain_dot(const value_type_of<T>* first, const value_type_of<T>* last, const value_type_of<U>* other, std::integral_constant<reduction, reduction::floating_moments>) noexcept {
+	return mapped_dot<U, T, Policy>(first, last, other);
+}
+template <typename U, typename T, typename Policy>
+double domain_dot(const value_type_of<T>* first, const value_type_of<T>* last, const value_type_of<U>* other, std::integral_constant<reduction, reduction::converted>) noexcept {
+	return lane_sum<double>(static_cast<std::size_t>(last - first), [first, other](const std::size_t i) {
+		return static_cast<double>(domain_cast<U, T, Policy>(first[i])) * static_cast<double>(other[i]);
+	});
+}
+
+/**
+ * Sum of the values in [first, last) converted from numeric_domain<T> to numeric_domain<U> (see reduction for how it is computed).
+ *
+ * Converted values are never written to memory. Since floating-point conversions are folded into the result instead of being applied to each value, results may differ from summing the results of domain_cast in the last places (they are usually more accurate).
+ * Integer sums (see integer_moments) need ranges of fewer than 2^47 values, which is asserted.
+ * For instance, domain_sum<float11, int16_t>(samples, samples + count) sums 16-bit samples with integer additions only, then maps the sum to float11.
+ */
+template <typename U, typename T, typename Policy = saturate>
+double domain_sum(const value_type_of<T>* first, const value_type_of<T>* last) noexcept {
+	static_assert(!integer_only || !std::is_floating_point<lane_type_of<U,T>>::value, "reductions are computed in floating point, which NUMERIC_DOMAIN_INTEGER_ONLY forbids");
+	return domain_sum<U, T, Policy>(first, last, reduction_of<U,T>());
+}
+
+/**
+ * Mean of the values in [first, last) converted from numeric_domain<T> to numeric_domain<U> (zero for an empty range).
+ */
+template <typename U, typename T, typename Policy = saturate>
+double domain_mean(const value_type_of<T>* first, const value_type_of<T>* last) noexcept {
+	return first == last ? 0 : domain_sum<U, T, Policy>(first, last) / static_cast<double>(last - first);
+}
+
+/**
+ * Root mean square of the values in [first, last) converted from numeric_domain<T> to numeric_domain<U> (zero for an empty range).
+ *
+ * For instance, domain_rms<float11, int16_t>(samples, samples + count) gives the RMS level of 16-bit samples as if they were converted to floats between -1 and 1.
+ * As with domain_sum, integer sums need ranges of fewer than 2^47 values; sums of squares are flushed to a wider accumulator (square_sum) every 2^31 values, so they never wrap.
+ */
+template <typename U, typename T, typename Policy = saturate>
+double domain_rms(const value_type_of<T>* first, const value_type_of<T>* last) noexcept {
+	static_assert(!integer_only || !std::is_floating_point<lane_type_of<U,T>>::value, "reductions are computed in floating point, which NUMERIC_DOMAIN_INTEGER_ONLY forbids");
+	return first == last ? 0 : domain_rms<U, T, Policy>(first, last, reduction_of<U,T>());
+}
+
+/**
+ * Whether a is smaller than b in magnitude, compared as unsigned integers for integers, so that the most negative one does not overflow.
+ */
+template <typename V>
+bool smaller_magnitude(const V a, const V b, std::true_type /* integral */) noexcept {
+	return magnitude(a) < magnitude(b);
+}
+template <typename V>
+bool smaller_magnitude(const V a, const V b, std::false_type /* integral */) noexcept {
+	return std::fabs(a) < std::fabs(b);
+}
+
+/**
+ * The value of [first, last) converted from numeric_domain<T> to numeric_domain<U> with the largest magnitude (e.g. -1 rather than 0.5), or zero for an empty range.
+ *
+ * Conversions are monotonic, so this is one of the conversions of the smallest and largest bounded source values: only these two are converted, after a pass which only compares source values.
+ * Unlike the other reductions, peaks of integer domains are found with integer arithmetic only, including with NUMERIC_DOMAIN_INTEGER_ONLY.
+ */
+template <typename U, typename T, typename Policy = saturate>
+value_type_of<U> domain_peak(const value_type_of<T>* first, const value_type_of<T>* last) noexcept {
+	if(first == last) return value_type_of<U>();
+	value_type_of<T> low = bounded<T, Policy>(*first);
+	value_type_of<T> high = low;
+	for(++first; first != last; ++first) {
+		const value_type_of<T> x = bounded<T, Policy>(*first);
+		low = x < low ? x : low;
+		high = x > high ? x : high;
+	}
+	const value_type_of<U> a = domain_cast<U, T, proven_in_range>(low);
+	const value_type_of<U> b = domain_cast<U, T, proven_in_range>(high);
+	return smaller_magnitude(a, b, std::is_integral<value_type_of<U>>()) ? b : a;
+}
+
+/**
+ * Dot product of the values in [first, last) converted from numeric_domain<T> to numeric_domain<U>, with as many values within numeric_domain<U> from other.
+ *
+ * For instance, domain_dot<float11, int8_t>(embedding, embedding + dimensions, query) compares an 8-bit embedding with a float query.
+ */
+template <typename U, typename T, typename Policy = saturate>
+double domain_dot(const value_type_of<T>* first, const value_type_of<T>* last, const value_type_of<U>* other) noexcept {
+	static_assert(!integer_only || !std::is_floating_point<lane_type_of<U,T>>::value, "reductions are computed in floating point, which NUMERIC_DOMAIN_INTEGER_ONLY forbids");
+	return domain_dot<U, T, Policy>(first, last, other, reduction_of<U,T>());
+}
+
+/**
+ * Dot product of the values in [first, last), each converted by its own domain_coefficients (e.g. from per-dimension dynamic domains), with as many values from other.
+ *
+ * Each value is clamped and mapped with a multiply-add in registers, then multiplied with the value of other.
+ */
+template <typename DynamicDomainTo, typename DynamicDomainFrom>
+double domain_dot(const domain_coefficients<DynamicDomainTo, DynamicDomainFrom>* coefficients, const typename DynamicDomainFrom::value_type* first, const typename DynamicDomainFrom::value_type* last, const typename DynamicDomainTo::value_type* other) noexcept {
+	typedef typename domain_coefficients<DynamicDomainTo, DynamicDomainFrom>::coefficient_type C;
+	static_assert(!integer_only || !std::is_floating_point<C>::value, "reductions are computed in floating point, which NUMERIC_DOMAIN_INTEGER_ONLY forbids");
+	return lane_sum<C>(static_cast<std::size_t>(last - first), [coefficients, first, other](const std::size_t i) {
+		const domain_coefficients<DynamicDomainTo, DynamicDomainFrom>& c = coefficients[i];
+		return ((bound_value(saturate(), static_cast<C>(first[i]), c.low, c.high) - c.low) * c.scale + c.origin) * static_cast<C>(other[i]);
+	});
+}
+
+}
@@ -0,0 +1,125 @@
+#pragma once
+/**
+ * Wait-free single-producer/single-consumer ring buffer converting between numeric domains on push and pop.
+ * Part of numeric_domain (see numeric_domain.hpp for copyright and license information).
+ */
+
+#include "numeric_domain.hpp"
+#include <atomic>
+
+namespace numeric_domain {
+/**
+ * A wait-free single-producer/single-consumer ring buffer of values within numeric_domain<T>.
+ *
+ * Values are converted while they are copied in (from the producer's domain to numeric_domain<T>) and out (from numeric_domain<T> to the consumer's domain), so that a block of samples crosses memory once instead of being converted in a separate pass.
+ * Storage is part of the object: pushing and popping never allocate, lock or call into the operating system, which makes the buffer suitable for real-time threads.
+ *
+ * Exactly one thread may push, and exactly one thread may pop. Capacity must be a power of two.
+ *
+ * For instance, an audio callback may push int16_t device samples into a domain_ring_buffer<float11, 1024>, from which a DSP thread pops float samples.
+ */
+template <typename T, std::size_t Capacity>
+class domain_ring_buffer {
+	static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "the capacity of a domain_ring_buffer must be a power of two");
+public:
+	typedef value_type_of<T> value_type;
+
+	domain_ring_buffer() noexcept : head(0), tail(0) {}
+	domain_ring_buffer(const domain_ring_buffer&) = delete;
+	domain_ring_buffer& operator=(const domain_ring_buffer&) = delete;
+
+	static constexpr std::size_t capacity() noexcept { return Capacity; }
+
+	/**
+	 * Number of values ready to be popped. Exact when called from the consumer thread; a lower bound of the free space is given by capacity() - size() on the producer thread.
+	 */
+	std::size_t size() const noexcept {
+		return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+	}
+
+	/**
+	 * Push up to count values within numeric_domain<T>. Returns the number of values actually pushed, which is less than count when the buffer is full.
+	 */
+	std::size_t push(const value_type* values, std::size_t count) noexcept {
+		return push_with(values, count, domain_caster<T,T>());
+	}
+
+	/**
+	 * Push up to count values within numeric_domain<From>, converting them to numeric_domain<T>. Returns the number of values actually pushed.
+	 */
+	template <typename From>
+	std::size_t push(const value_type_of<From>* values, std::size_t count) noexcept {
+		return push_with(values, count, domain_caster<T,From>());
+	}
+
+	/**
+	 * Push up to count values within a given dynamic domain, converting them to numeric_domain<T>. Returns the number of values actually pushed.
+	 */
+	template <typename DynamicDomainFrom>
+	std::size_t push(const typename DynamicDomainFrom::value_type* values, std::size_t count, const DynamicDomainFrom from) noexcept {
+		return push_with(values, count, make_caster(make_domain<T>(), from));
+	}
+
+	/**
+	 * Push up to count values, converting them to numeric_domain<T> with the given caster. Returns the number of values actually pushed.
+	 */
+	template <typename V, typename Caster>
+	std::size_t push_with(const V* values, std::size_t count, Caster caster) noexcept {
+		const std::size_t h = head.load(std::memory_order_relaxed);
+		const std::size_t available = Capacity - (h - tail.load(std::memory_order_acquire));
+		const std::size_t n = std::min(count, available);
+		const std::size_t first = h & (Capacity - 1);
+		const std::size_t wrapped = std::min(n, Capacity - first);
+		domain_transform(values, values + wrapped, buffer + first, caster);
+		domain_transform(values + wrapped, values + n, buffer, caster);
+		head.store(h + n, std::memory_order_release);
+		return n;
+	}
+
+	/**
+	 * Pop up to count values within numeric_domain<T>. Returns the number of values actually popped, which is less than count when the buffer runs empty.
+	 */
+	std::size_t pop(value_type* out, std::size_t count) noexcept {
+		return pop_with(out, count, domain_caster<T,T>());
+	}
+
+	/**
+	 * Pop up to count values, converting them to numeric_domain<To>. Returns the number of values actually popped.
+	 */
+	template <typename To>
+	std::size_t pop(value_type_of<To>* out, std::size_t count) noexcept {
+		return pop_with(out, count, domain_caster<To,T>());
+	}
+
+	/**
+	 * Pop up to count values, converting them to a given dynamic domain. Returns the number of values actually popped.
+	 */
+	template <typename DynamicDomainTo>
+	std::size_t pop(typename DynamicDomainTo::value_type* out, std::size_t count, const DynamicDomainTo to) noexcept {
+		return pop_with(out, count, make_caster(to, make_domain<T>()));
+	}
+
+	/**
+	 * Pop up to count values, converting them from numeric_domain<T> with the given caster. Returns the number of values actually popped.
+	 */
+	template <typename U, typename Caster>
+	std::size_t pop_with(U* out, std::size_t count, Caster caster) noexcept {
+		const std::size_t t = tail.load(std::memory_order_relaxed);
+		const std::size_t available = head.load(std::memory_order_acquire) - t;
+		const std::size_t n = std::min(count, available);
+		const std::size_t first = t & (Capacity - 1);
+		const std::size_t wrapped = std::min(n, Capacity - first);
+		domain_transform(buffer + first, buffer + first + wrapped, out, caster);
+		domain_transform(buffer, buffer + (n - wrapped), out + wrapped, caster);
+		tail.store(t + n, std::memory_order_release);
+		return n;
+	}
+
+private:
+	value_type buffer[Capacity];
+	// Both counters only ever increase (modulo 2^N, which Capacity divides). They live on separate cache lines so that the producer and the consumer do not invalidate each other's line on every update.
+	alignas(64) std::atomic<std::size_t> head;
+	alignas(64) std::atomic<std::size_t> tail;
+};
+
+}
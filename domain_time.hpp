@@ -0,0 +1,63 @@
+#pragma once
+/**
+ * Exact rebasing of 64-bit tick counters from one time base to another.
+ * Part of numeric_domain (see numeric_domain.hpp for copyright and license information).
+ */
+
+#include "numeric_domain.hpp"
+
+namespace numeric_domain {
+/**
+ * A tag for 64-bit tick counters whose ticks last Period seconds, as with the period of a std::chrono::duration.
+ *
+ * For instance, time_base<std::ratio<1, 48000>> counts samples of a 48 kHz clock, and time_base<std::nano> counts nanoseconds.
+ * Unlike numeric domains, time bases are not bounded: converting between them scales ticks by the ratio of their periods, so that both counts stand for the same duration.
+ */
+template <typename Period>
+struct time_base {};
+
+/**
+ * Converts tick counts from one time base to another: ticks * FromPeriod / ToPeriod, rounded down.
+ *
+ * The ratio of both periods is reduced at compile time to num / den, and applied like ratio_scale: ticks are split into a quotient and a remainder of den, so that no intermediate product is wider than 64 bits.
+ * The compiler turns the divisions by the constant den into multiply-highs, so conversions are exact over the full uint64_t range, without double or 128-bit arithmetic.
+ * Results beyond the range of uint64_t saturate to its maximum.
+ */
+template <typename To, typename From>
+struct time_caster;
+template <typename ToPeriod, typename FromPeriod>
+struct time_caster<time_base<ToPeriod>, time_base<FromPeriod>> {
+	typedef std::ratio_divide<FromPeriod, ToPeriod> ratio;
+	static_assert(ratio::num > 0, "time bases must have positive periods");
+
+	static constexpr std::uint64_t num = ratio::num;
+	static constexpr std::uint64_t den = ratio::den;
+	static_assert(num <= std::numeric_limits<std::uint64_t>::max() / den, "the remainder of a tick count times the ratio of both periods must fit in 64 bits");
+
+	NUMERIC_DOMAIN_CONSTEXPR14 std::uint64_t operator()(const std::uint64_t ticks) const noexcept {
+		const std::uint64_t quotient = ticks / den;
+		const std::uint64_t remainder = ticks % den * num / den;
+		const std::uint64_t scaled = quotient * num + remainder;
+		return quotient > std::numeric_limits<std::uint64_t>::max() / num || scaled < remainder ? std::numeric_limits<std::uint64_t>::max() : scaled;
+	}
+};
+
+/**
+ * Convert a tick count from time base From to time base To.
+ *
+ * For instance, time_cast<time_base<std::nano>, time_base<std::ratio<1, 48000>>>(48000) gives 1000000000.
+ */
+template <typename To, typename From>
+NUMERIC_DOMAIN_CONSTEXPR14 std::uint64_t time_cast(const std::uint64_t ticks) noexcept {
+	return time_caster<To, From>()(ticks);
+}
+
+/**
+ * Convert the contiguous tick counts in [first, last) from time base From to time base To, writing the results to out. Returns the end of the output range.
+ */
+template <typename To, typename From>
+NUMERIC_DOMAIN_CONSTEXPR14 std::uint64_t* time_cast(const std::uint64_t* first, const std::uint64_t* last, std::uint64_t* out) noexcept {
+	return domain_transform(first, last, out, time_caster<To, From>());
+}
+
+}
@@ -0,0 +1,233 @@
+#pragma once
+/**
+ * Lazy views converting the elements of a sequence from one numeric domain to another while they are iterated over.
+ * Part of numeric_domain (see numeric_domain.hpp for copyright and license information).
+ */
+
+#include "numeric_domain.hpp"
+#include <iterator>
+
+namespace numeric_domain {
+/**
+ * An iterator converting the elements of another iterator with a caster when dereferenced.
+ *
+ * Dereferencing gives converted values (prvalues), not references: elements cannot be assigned through it.
+ * Since forward iterators must give references, it is an input iterator, whatever the underlying iterator; it still has the operations of the underlying iterator (e.g. indexing and distances, for random-access sequences), and C++20 algorithms see its category as iterator_concept.
+ */
+template <typename Iterator, typename Caster>
+class converting_iterator {
+public:
+	typedef std::input_iterator_tag iterator_category;
+	typedef typename std::iterator_traits<Iterator>::iterator_category iterator_concept;
+	typedef typename std::decay<decltype(std::declval<const Caster&>()(*std::declval<Iterator>()))>::type value_type;
+	typedef typename std::iterator_traits<Iterator>::difference_type difference_type;
+	typedef value_type reference;
+	typedef void pointer;
+
+	converting_iterator() = default;
+	converting_iterator(const Iterator iterator, const Caster caster) : iterator(iterator), converter(caster) {}
+
+	const Iterator& base() const noexcept { return iterator; }
+	const Caster& caster() const noexcept { return converter; }
+
+	reference operator*() const noexcept { return converter(*iterator); }
+	reference operator[](const difference_type n) const noexcept { return converter(iterator[n]); }
+
+	converting_iterator& operator++() { ++iterator; return *this; }
+	converting_iterator& operator--() { --iterator; return *this; }
+	converting_iterator operator++(int) { converting_iterator previous = *this; ++iterator; return previous; }
+	converting_iterator operator--(int) { converting_iterator previous = *this; --iterator; return previous; }
+	converting_iterator& operator+=(const difference_type n) { iterator += n; return *this; }
+	converting_iterator& operator-=(const difference_type n) { iterator -= n; return *this; }
+	converting_iterator operator+(const difference_type n) const { return converting_iterator(iterator + n, converter); }
+	converting_iterator operator-(const difference_type n) const { return converting_iterator(iterator - n, converter); }
+	difference_type operator-(const converting_iterator& other) const { return iterator - other.iterator; }
+	friend converting_iterator operator+(const difference_type n, const converting_iterator& i) { return i + n; }
+
+	bool operator==(const converting_iterator& other) const { return iterator == other.iterator; }
+	bool operator!=(const converting_iterator& other) const { return iterator != other.iterator; }
+	bool operator<(const converting_iterator& other) const { return iterator < other.iterator; }
+	bool operator>(const converting_iterator& other) const { return iterator > other.iterator; }
+	bool operator<=(const converting_iterator& other) const { return iterator <= other.iterator; }
+	bool operator>=(const converting_iterator& other) const { return iterator >= other.iterator; }
+
+private:
+	Iterator iterator;
+	Caster converter;
+};
+
+/**
+ * A caster applying Inner, then Outer.
+ */
+template <typename Outer, typename Inner>
+struct composed_caster {
+	Outer outer;
+	Inner inner;
+
+	template <typename V>
+	constexpr auto operator()(const V value) const noexcept -> decltype(outer(inner(value))) {
+		return outer(inner(value));
+	}
+};
+
+/**
+ * Convert the contiguous values in [first, last) with a caster, writing the results to out. Returns the end of the output range.
+ *
+ * Composed casters are applied one after the other, through a buffer on the stack holding a chunk of intermediate values, rather than fused into one loop:
+ * each stage then runs in the vectorized loop of domain_transform, which the clamps of consecutive conversions (turned into branches once fused) would prevent.
+ */
+template <typename T, typename U, typename Caster>
+U* chunked_transform(const T* first, const T* last, U* out, const Caster& caster) noexcept {
+	return domain_transform(first, last, out, caster);
+}
+template <typename T, typename U, typename Outer, typename Inner>
+U* chunked_transform(const T* first, const T* last, U* out, const composed_caster<Outer, Inner>& caster) noexcept {
+	typedef typename std::decay<decltype(caster.inner(*first))>::type intermediate;
+	intermediate buffer[256];
+	while(first != last) {
+		const std::ptrdiff_t count = std::min<std::ptrdiff_t>(last - first, 256);
+		chunked_transform(first, first + count, buffer, caster.inner);
+		out = chunked_transform(static_cast<const intermediate*>(buffer), buffer + count, out, caster.outer);
+		first += count;
+	}
+	return out;
+}
+
+/**
+ * The innermost iterator below nested converting iterators (e.g. a pointer, for views of views of an array), and the composition of their casters with Caster.
+ */
+template <typename Iterator, typename Caster>
+struct flattened {
+	typedef Iterator base_type;
+	typedef Caster caster_type;
+
+	static base_type base(const Iterator& iterator) noexcept { return iterator; }
+	static caster_type caster(const Iterator&, const Caster& caster) noexcept { return caster; }
+};
+template <typename Inner, typename InnerCaster, typename Caster>
+struct flattened<converting_iterator<Inner, InnerCaster>, Caster> {
+	typedef flattened<Inner, composed_caster<Caster, InnerCaster>> inner;
+	typedef typename inner::base_type base_type;
+	typedef typename inner::caster_type caster_type;
+
+	static base_type base(const converting_iterator<Inner, InnerCaster>& iterator) noexcept {
+		return inner::base(iterator.base());
+	}
+	static caster_type caster(const converting_iterator<Inner, InnerCaster>& iterator, const Caster& caster) noexcept {
+		return inner::caster(iterator.base(), composed_caster<Caster, InnerCaster>{caster, iterator.caster()});
+	}
+};
+
+/**
+ * A view of the elements of [first, last), converted with a caster when iterated over. Nothing is converted nor stored up front.
+ *
+ * Views hold iterators, not the sequence itself, which must outlive them (as with std::string_view). They are cheap to copy, and may be viewed in turn (to chain conversions) or passed to anything taking a range.
+ * copy_to() converts every element at once: when the elements of the innermost sequence are contiguous and written to a pointer, it goes through chunked_transform, so that chains of views still hit the vectorized batch loop without allocating temporary buffers.
+ */
+template <typename Iterator, typename Caster>
+class converted_range {
+public:
+	typedef converting_iterator<Iterator, Caster> iterator;
+	typedef iterator const_iterator;
+	typedef typename iterator::value_type value_type;
+	typedef typename iterator::difference_type difference_type;
+	typedef std::size_t size_type;
+
+	converted_range(const Iterator first, const Iterator last, const Caster caster) : first(first), last(last), caster(caster) {}
+
+	iterator begin() const { return iterator(first, caster); }
+	iterator end() const { return iterator(last, caster); }
+	bool empty() const { return first == last; }
+	size_type size() const { return static_cast<size_type>(std::distance(first, last)); }
+	value_type operator[](const size_type i) const { return begin()[static_cast<difference_type>(i)]; }
+
+	/**
+	 * Convert every element, writing them to out. Returns the end of the output range.
+	 */
+	template <typename OutputIterator>
+	OutputIterator copy_to(OutputIterator out) const {
+		typedef flattened<Iterator, Caster> flat;
+		return copy_to(flat::base(first), flat::base(last), out, flat::caster(first, caster),
+			std::integral_constant<bool, std::is_pointer<typename flat::base_type>::value && std::is_pointer<OutputIterator>::value>());
+	}
+
+private:
+	template <typename Base, typename OutputIterator, typename FlatCaster>
+	static OutputIterator copy_to(const Base from, const Base to, OutputIterator out, const FlatCaster flat_caster, std::true_type /* contiguous */) noexcept {
+		return chunked_transform(from, to, out, flat_caster);
+	}
+	template <typename Base, typename OutputIterator, typename FlatCaster>
+	static OutputIterator copy_to(Base from, const Base to, OutputIterator out, const FlatCaster flat_caster, std::false_type /* not contiguous */) {
+		for(; from != to; ++from, ++out) {
+			*out = flat_caster(*from);
+		}
+		return out;
+	}
+
+	Iterator first;
+	Iterator last;
+	Caster caster;
+};
+
+template <typename Range>
+struct is_converted_range : std::false_type {};
+template <typename Iterator, typename Caster>
+struct is_converted_range<converted_range<Iterator, Caster>> : std::true_type {};
+
+/**
+ * Whether Range, as deduced from a forwarding reference, is a temporary sequence, which would be destroyed before a view of it is used.
+ * Temporary views are fine: they only hold iterators.
+ */
+template <typename Range>
+struct is_temporary_sequence : std::integral_constant<bool, !std::is_lvalue_reference<Range>::value && !is_converted_range<typename std::decay<Range>::type>::value> {};
+
+/**
+ * How views iterate over a range: with std::begin() and std::end(), except for contiguous containers (whose data() points to their elements, as with std::vector), which are iterated over with pointers so that copy_to() can use the batch loop.
+ */
+template <typename Range, typename = void>
+struct range_traits {
+	typedef decltype(std::begin(std::declval<const Range&>())) iterator;
+
+	static iterator first(const Range& range) { return std::begin(range); }
+	static iterator last(const Range& range) { return std::end(range); }
+};
+template <typename Range>
+struct range_traits<Range, typename std::enable_if<std::is_same<decltype(std::declval<const Range&>().data()),
+	const typename std::decay<decltype(*std::begin(std::declval<const Range&>()))>::type*>::value>::type> {
+	typedef decltype(std::declval<const Range&>().data()) iterator;
+
+	static iterator first(const Range& range) { return range.data(); }
+	static iterator last(const Range& range) { return range.data() + range.size(); }
+};
+
+/**
+ * A lazy view of the elements of range (anything with std::begin() and std::end(): arrays, containers or other views), converted from numeric_domain<From> to numeric_domain<To>.
+ *
+ * For instance, std::accumulate(view.begin(), view.end(), 0.0f) with view = domain_view<float11, int16_t>(samples) sums samples as floats without converting them to a buffer first.
+ */
+template <typename To, typename From, typename Policy = saturate, typename Range>
+converted_range<typename range_traits<Range>::iterator, domain_caster<To, From, Policy>> domain_view(const Range& range) {
+	return converted_range<typename range_traits<Range>::iterator, domain_caster<To, From, Policy>>(range_traits<Range>::first(range), range_traits<Range>::last(range), domain_caster<To, From, Policy>());
+}
+// Views of temporary sequences would dangle.
+template <typename To, typename From, typename Policy = saturate, typename Range, typename = typename std::enable_if<is_temporary_sequence<Range>::value>::type>
+void domain_view(Range&& range) = delete;
+
+/**
+ * A lazy view of the elements of range, converted from a given dynamic domain to another.
+ * The conversion is prepared once, by a dynamic_domain_caster.
+ */
+template <typename DynamicDomainTo, typename Range, typename DynamicDomainFrom>
+auto domain_view(const DynamicDomainTo to, const Range& range, const DynamicDomainFrom from) -> converted_range<typename range_traits<Range>::iterator, decltype(make_caster(to, from))> {
+	return converted_range<typename range_traits<Range>::iterator, decltype(make_caster(to, from))>(range_traits<Range>::first(range), range_traits<Range>::last(range), make_caster(to, from));
+}
+template <typename DynamicDomainTo, typename Range, typename DynamicDomainFrom, typename Policy>
+auto domain_view(const DynamicDomainTo to, const Range& range, const DynamicDomainFrom from, Policy) -> converted_range<typename range_traits<Range>::iterator, decltype(make_caster(to, from, Policy()))> {
+	return converted_range<typename range_traits<Range>::iterator, decltype(make_caster(to, from, Policy()))>(range_traits<Range>::first(range), range_traits<Range>::last(range), make_caster(to, from, Policy()));
+}
+template <typename DynamicDomainTo, typename Range, typename DynamicDomainFrom, typename = typename std::enable_if<is_temporary_sequence<Range>::value>::type>
+void domain_view(const DynamicDomainTo to, Range&& range, const DynamicDomainFrom from) = delete;
+template <typename DynamicDomainTo, typename Range, typename DynamicDomainFrom, typename Policy, typename = typename std::enable_if<is_temporary_sequence<Range>::value>::type>
+void domain_view(const DynamicDomainTo to, Range&& range, const DynamicDomainFrom from, Policy) = delete;
+
+}
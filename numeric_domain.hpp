@@ -1,6 +1,10 @@
 #pragma once
 /**
  * C++11 header-only library for conversions between bounded ranges of different types.
+ *
+ * Real-time safety: every domain_cast overload, domain_caster, dynamic_domain_caster and batch conversion (domain_transform) is noexcept, and never allocates memory, takes a lock or makes a system call, including the first time it is called (nothing is built lazily).
+ * This makes them usable on audio and other real-time threads. test.cpp enforces it by counting allocations around these calls; new conversion paths must keep it that way.
+ *
  * (C) 2016 Jonathan Aceituno <join@oin.name> (http://oin.name)
  *
  * License: MIT
@@ -16,8 +20,40 @@
 #include <limits>
 #include <algorithm>
 #include <ratio>
+#include <cstddef>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <array>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define NUMERIC_DOMAIN_SSE2
+#endif
 
 namespace numeric_domain {
+/**
+ * Integer-only mode, for targets without a floating-point unit (on which each floating-point operation becomes a call into a software library).
+ *
+ * When NUMERIC_DOMAIN_INTEGER_ONLY is defined before including this header, every conversion computed in floating point fails to compile.
+ * Conversions between integer domains, static or dynamic, are then guaranteed to be computed with integer arithmetic only (codegen.sh checks it).
+ */
+#if defined(NUMERIC_DOMAIN_INTEGER_ONLY)
+constexpr bool integer_only = true;
+#else
+constexpr bool integer_only = false;
+#endif
+
+/**
+ * constexpr for functions which need C++14 relaxed constexpr (local variables, loops), and nothing in C++11.
+ * Everything else is constexpr in C++11 already, so that conversions between constant values and domains can be computed at compile time.
+ */
+#if defined(__cpp_constexpr) && __cpp_constexpr >= 201304
+#define NUMERIC_DOMAIN_CONSTEXPR14 constexpr
+#else
+#define NUMERIC_DOMAIN_CONSTEXPR14
+#endif
+
 /**
  * numeric_domain<T> provides static numeric bounds/range information for type T.
  * See dynamic_domain<T> for a version where bounds are free to change at runtime.
@@ -54,33 +90,172 @@ using extent_type_of = decltype(std::declval<value_type_of<T>>() - std::declval<
  * Return the extent of a numeric_domain type; i.e., the difference between its maximum and its minimum value.
  */
 template <typename T>
-constexpr extent_type_of<T> extent_of() {
+constexpr extent_type_of<T> extent_of() noexcept {
 	return numeric_domain<T>::max() - numeric_domain<T>::min();
 }
 
+/**
+ * Policies for values found outside of the source domain of a conversion, given as the last template argument of domain_cast and domain_caster (or as a trailing argument for dynamic domains).
+ */
+
+/**
+ * Clamp values to the bounds of the source domain. This is the default policy.
+ */
+struct saturate {};
+
+/**
+ * Wrap values around the source domain, as phase accumulators do.
+ *
+ * Integer domains wrap modulo their extent plus one (max + 1 becomes min), since both of their bounds are valid values.
+ * Floating-point domains wrap modulo their extent (max becomes min).
+ */
+struct wrap {};
+
+/**
+ * Assume values are within the source domain. The caller guarantees it, and it is only checked by an assertion in debug builds.
+ *
+ * Between static domains, conversions computed in floating point are then folded to a single multiply-add, whose result may differ from saturate in the last place.
+ */
+struct unchecked {};
+
+/**
+ * Leave values alone, because they cannot be outside the source domain.
+ *
+ * domain_caster selects this policy by itself instead of saturate or wrap when the source domain covers every value of its type (see is_full_range).
+ */
+struct proven_in_range {};
+
+/**
+ * Apply a policy to a value of a source domain (tmin, tmax).
+ */
+template <typename T>
+constexpr T bound_value(saturate, const T t, const T tmin, const T tmax) noexcept {
+	// Same as std::max(tmin, std::min(tmax, t)), including for NaN (which becomes tmax).
+	return tmin < (t < tmax ? t : tmax) ? (t < tmax ? t : tmax) : tmin;
+}
+
+template <typename T>
+constexpr T bound_value(proven_in_range, const T t, const T, const T) noexcept {
+	return t;
+}
+
+template <typename T>
+constexpr T bound_value(unchecked, const T t, const T tmin, const T tmax) noexcept {
+	return (tmin <= t && t <= tmax) ? t : (assert(!"unchecked conversion of a value outside of its source domain"), t);
+}
+
+constexpr std::uintmax_t wrap_offset(const std::uintmax_t distance, const std::uintmax_t count, const bool below) noexcept {
+	return below ? (count - distance % count) % count : distance % count;
+}
+
+template <typename T>
+constexpr T wrap_value(const T t, const T tmin, const T tmax, std::true_type /* integral */) noexcept {
+	// Computed with unsigned arithmetic, so that differences between bounds never overflow.
+	return tmin <= t && t <= tmax ? t : static_cast<T>(static_cast<std::uintmax_t>(tmin) + wrap_offset(
+		t < tmin ? static_cast<std::uintmax_t>(tmin) - static_cast<std::uintmax_t>(t) : static_cast<std::uintmax_t>(t) - static_cast<std::uintmax_t>(tmin),
+		static_cast<std::uintmax_t>(tmax) - static_cast<std::uintmax_t>(tmin) + 1,
+		t < tmin));
+}
+
+template <typename T>
+T wrap_value(const T t, const T tmin, const T tmax, std::false_type /* floating-point */) noexcept {
+	static_assert(!integer_only || !std::is_floating_point<T>::value, "this conversion is computed in floating point, which NUMERIC_DOMAIN_INTEGER_ONLY forbids");
+	if(tmin <= t && t < tmax) return t;
+	T wrapped = std::fmod(t - tmin, tmax - tmin);
+	return tmin + (wrapped < 0 ? wrapped + (tmax - tmin) : wrapped);
+}
+
+template <typename T>
+constexpr T bound_value(wrap, const T t, const T tmin, const T tmax) noexcept {
+	return wrap_value(t, tmin, tmax, std::is_integral<T>());
+}
+
+/**
+ * Magnitude of an integer, as an unsigned integer (so that it never overflows).
+ */
+template <typename T>
+constexpr std::uintmax_t magnitude(const T x) noexcept {
+	return x < T() ? 0 - static_cast<std::uintmax_t>(x) : static_cast<std::uintmax_t>(x);
+}
+
+/**
+ * Long division of the 128-bit number (remainder, low) by divisor, one bit of low at a time, when the quotient fits in 64 bits (remainder < divisor).
+ */
+constexpr std::uint64_t divide_wide(const std::uint64_t remainder, const std::uint64_t low, const std::uint64_t divisor, const std::uint64_t quotient, const unsigned bits) noexcept;
+constexpr std::uint64_t divide_wide_step(const bool carry, const std::uint64_t shifted, const std::uint64_t low, const std::uint64_t divisor, const std::uint64_t quotient, const unsigned bits) noexcept {
+	return carry || shifted >= divisor ? divide_wide(shifted - divisor, low, divisor, quotient << 1 | 1, bits - 1) : divide_wide(shifted, low, divisor, quotient << 1, bits - 1);
+}
+constexpr std::uint64_t divide_wide(const std::uint64_t remainder, const std::uint64_t low, const std::uint64_t divisor, const std::uint64_t quotient, const unsigned bits) noexcept {
+	return bits == 0 ? quotient : divide_wide_step(remainder >> 63 != 0, remainder << 1 | low >> 63, low << 1, divisor, quotient, bits);
+}
+
+/**
+ * The high 64 bits of the product of a and b, from the products of their 32-bit halves (cross is the high half of a times the low half of b, plus the carry of both low halves).
+ */
+constexpr std::uint64_t multiply_high(const std::uint64_t a, const std::uint64_t b, const std::uint64_t cross) noexcept {
+	return (a >> 32) * (b >> 32) + (cross >> 32) + (((a & 0xffffffffu) * (b >> 32) + (cross & 0xffffffffu)) >> 32);
+}
+constexpr std::uint64_t multiply_high(const std::uint64_t a, const std::uint64_t b) noexcept {
+	return multiply_high(a, b, (a >> 32) * (b & 0xffffffffu) + ((a & 0xffffffffu) * (b & 0xffffffffu) >> 32));
+}
+
+#if defined(__SIZEOF_INT128__)
+constexpr std::uint64_t divide_product(const unsigned __int128 product, const std::uint64_t divisor) noexcept {
+	return product >> 64 ? static_cast<std::uint64_t>(product / divisor) : static_cast<std::uint64_t>(product) / divisor;
+}
+#endif
+
+/**
+ * a * b / c, truncated, computed with a 128-bit product so that it never overflows. The quotient must fit in 64 bits (e.g. a <= c), and c must not be zero.
+ *
+ * Products which fit in 64 bits are divided with a 64-bit division.
+ * Without 128-bit integer support (__int128), wider products are divided by long division.
+ */
+constexpr std::uint64_t multiply_divide(const std::uint64_t a, const std::uint64_t b, const std::uint64_t c) noexcept {
+#if defined(__SIZEOF_INT128__)
+	return divide_product(static_cast<unsigned __int128>(a) * b, c);
+#else
+	return b == 0 || a <= std::numeric_limits<std::uint64_t>::max() / b ? a * b / c : divide_wide(multiply_high(a, b), a * b, c, 0, 64);
+#endif
+}
+
 /**
  * Convert a value within specific bounds.
  *
- * The value is clamped if outside (tmin, tmax).
+ * The value is brought within (tmin, tmax) according to Policy (by default, it is clamped).
  * It is then rescaled to the range described by umin and uextent.
+ * Between integers, the rescaling is computed on unsigned magnitudes with a 128-bit product (see multiply_divide), so that it never overflows; it is truncated toward zero, as with the / operator.
  */
 template <typename U, typename UExtent, typename T, typename TExtent>
-U domain_convert(const T t, const T tmin, const T tmax, const TExtent textent, const U umin, const UExtent uextent) {
-	T bounded = std::max(tmin, std::min(tmax, t));
-	auto scaled = (bounded - tmin) * uextent;
-	auto rescaled = umin + scaled / textent;
-	return static_cast<U>(rescaled);
+constexpr U integer_convert(const T bounded, const T tmin, const TExtent textent, const U umin, const UExtent uextent) noexcept {
+	return static_cast<U>(((bounded < tmin) != (uextent < UExtent())) != (textent < TExtent())
+		? static_cast<std::uintmax_t>(umin) - multiply_divide(bounded < tmin ? static_cast<std::uintmax_t>(tmin) - static_cast<std::uintmax_t>(bounded) : static_cast<std::uintmax_t>(bounded) - static_cast<std::uintmax_t>(tmin), magnitude(uextent), magnitude(textent))
+		: static_cast<std::uintmax_t>(umin) + multiply_divide(bounded < tmin ? static_cast<std::uintmax_t>(tmin) - static_cast<std::uintmax_t>(bounded) : static_cast<std::uintmax_t>(bounded) - static_cast<std::uintmax_t>(tmin), magnitude(uextent), magnitude(textent)));
+}
+template <typename Policy, typename U, typename UExtent, typename T, typename TExtent>
+constexpr U domain_convert(const T t, const T tmin, const T tmax, const TExtent textent, const U umin, const UExtent uextent, std::true_type /* integral */) noexcept {
+	return integer_convert(bound_value(Policy(), t, tmin, tmax), tmin, textent, umin, uextent);
+}
+template <typename Policy, typename U, typename UExtent, typename T, typename TExtent>
+constexpr U domain_convert(const T t, const T tmin, const T tmax, const TExtent textent, const U umin, const UExtent uextent, std::false_type /* integral */) noexcept {
+	return static_cast<U>(umin + (bound_value(Policy(), t, tmin, tmax) - tmin) * uextent / textent);
+}
+template <typename Policy = saturate, typename U, typename UExtent, typename T, typename TExtent>
+constexpr U domain_convert(const T t, const T tmin, const T tmax, const TExtent textent, const U umin, const UExtent uextent) noexcept {
+	static_assert(!integer_only || std::is_integral<decltype(umin + (t - tmin) * uextent / textent)>::value, "this conversion is computed in floating point, which NUMERIC_DOMAIN_INTEGER_ONLY forbids");
+	return domain_convert<Policy>(t, tmin, tmax, textent, umin, uextent, std::integral_constant<bool, std::is_integral<decltype(umin + (t - tmin) * uextent / textent)>::value>());
 }
 
 /**
  * Convert a value within specific bounds.
  *
- * The value is clamped if outside (tmin, tmax).
+ * The value is brought within (tmin, tmax) according to Policy (by default, it is clamped).
  * It is then rescaled to the range described by umin and uextent.
  */
-template <typename U, typename UExtent, typename T, typename TExtent>
-constexpr U static_domain_convert(const T t, const T tmin, const T tmax, const TExtent textent, const U umin, const UExtent uextent) {
-	return static_cast<U>(umin + (std::max(tmin, std::min(tmax, t)) - tmin) * uextent / textent);
+template <typename Policy = saturate, typename U, typename UExtent, typename T, typename TExtent>
+constexpr U static_domain_convert(const T t, const T tmin, const T tmax, const TExtent textent, const U umin, const UExtent uextent) noexcept {
+	static_assert(!integer_only || std::is_integral<decltype(umin + (t - tmin) * uextent / textent)>::value, "this conversion is computed in floating point, which NUMERIC_DOMAIN_INTEGER_ONLY forbids");
+	return static_cast<U>(umin + (bound_value(Policy(), t, tmin, tmax) - tmin) * uextent / textent);
 }
 
 /**
@@ -89,8 +264,8 @@ constexpr U static_domain_convert(const T t, const T tmin, const T tmax, const T
 template <typename T>
 struct numeric_domain<T, typename std::enable_if<std::is_arithmetic<T>::value>::type> {
 	typedef T value_type;
-	static constexpr const value_type min() { return std::numeric_limits<value_type>::min(); }
-	static constexpr const value_type max() { return std::numeric_limits<value_type>::max(); }
+	static constexpr const value_type min() noexcept { return std::numeric_limits<value_type>::min(); }
+	static constexpr const value_type max() noexcept { return std::numeric_limits<value_type>::max(); }
 };
 
 /**
@@ -99,14 +274,59 @@ struct numeric_domain<T, typename std::enable_if<std::is_arithmetic<T>::value>::
 template <typename T, std::intmax_t Min = std::numeric_limits<T>::min(), std::uintmax_t Max = std::numeric_limits<T>::max(), typename RatioScaler = std::ratio<1, 1>>
 struct arithmetic_t {};
 
+/**
+ * value * Ratio::num / Ratio::den, truncated.
+ *
+ * Integers are split into a quotient and a remainder of Ratio::den first, so that value * Ratio::num is never computed: only the result (and the remainder times Ratio::num) must fit in V.
+ */
+template <typename Ratio, typename V>
+constexpr V ratio_scale(const V value, std::true_type /* integral */) noexcept {
+	return static_cast<V>(value / Ratio::den * Ratio::num + value % Ratio::den * Ratio::num / Ratio::den);
+}
+template <typename Ratio, typename V>
+constexpr V ratio_scale(const V value, std::false_type /* floating-point */) noexcept {
+	return Ratio::num * value / Ratio::den;
+}
+
 /**
  * Template specialization of numeric_domain for arithmetic_t<...> types.
  */
 template <typename T, std::intmax_t Min, std::uintmax_t Max, typename RatioScaler>
 struct numeric_domain<arithmetic_t<T, Min, Max, RatioScaler>> {
 	typedef T value_type;
-	static constexpr const value_type min() { return RatioScaler::num * static_cast<value_type>(Min) / RatioScaler::den; }
-	static constexpr const value_type max() { return RatioScaler::num * static_cast<value_type>(Max) / RatioScaler::den; }
+	static constexpr const value_type min() noexcept { return ratio_scale<RatioScaler>(static_cast<value_type>(Min), std::is_integral<value_type>()); }
+	static constexpr const value_type max() noexcept { return ratio_scale<RatioScaler>(static_cast<value_type>(Max), std::is_integral<value_type>()); }
+};
+
+/**
+ * The value of a std::ratio as type V (truncated for integers, rounded once for floating-point numbers).
+ */
+template <typename V, typename Ratio>
+constexpr V ratio_value(std::true_type /* integral */) noexcept {
+	return static_cast<V>(Ratio::num / Ratio::den);
+}
+template <typename V, typename Ratio>
+constexpr V ratio_value(std::false_type /* floating-point */) noexcept {
+	return static_cast<V>(static_cast<long double>(Ratio::num) / static_cast<long double>(Ratio::den));
+}
+
+/**
+ * A tag for an arithmetic type bounded between two rational values MinRatio and MaxRatio, given as std::ratio.
+ *
+ * Unlike with arithmetic_t, both bounds are independent and need not be integers: rational_t<float, std::ratio<-1, 4>, std::ratio<3, 4>> stands for floats between -0.25 and 0.75, and rational_t<float, std::ratio<1, 3>, std::ratio<2>> for floats between 1/3 and 2.
+ * Since the bounds are known exactly, so are the folded coefficients of conversions from or to such domains (see exact_bounds).
+ */
+template <typename T, typename MinRatio, typename MaxRatio>
+struct rational_t {};
+
+/**
+ * Template specialization of numeric_domain for rational_t<...> types.
+ */
+template <typename T, typename MinRatio, typename MaxRatio>
+struct numeric_domain<rational_t<T, MinRatio, MaxRatio>> {
+	typedef T value_type;
+	static constexpr const value_type min() noexcept { return ratio_value<value_type, MinRatio>(std::is_integral<value_type>()); }
+	static constexpr const value_type max() noexcept { return ratio_value<value_type, MaxRatio>(std::is_integral<value_type>()); }
 };
 
 /**
@@ -136,6 +356,55 @@ using float11 = arithmetic_t<float, -1, 1>;
  */
 using float_0_and_0_5 = arithmetic_t<float, 0, 1, std::ratio<1,2>>;
 
+/**
+ * A compile-time sequence of indices, like C++14's std::index_sequence.
+ * make_index_sequence<N> is built by halves, so that the depth of template instantiation only grows with the logarithm of N.
+ */
+template <std::size_t... Is>
+struct index_sequence {};
+
+template <typename A, typename B>
+struct concatenate_indices {};
+template <std::size_t... As, std::size_t... Bs>
+struct concatenate_indices<index_sequence<As...>, index_sequence<Bs...>> {
+	typedef index_sequence<As..., (sizeof...(As) + Bs)...> type;
+};
+
+template <std::size_t N>
+struct make_index_sequence_of : concatenate_indices<typename make_index_sequence_of<N / 2>::type, typename make_index_sequence_of<N - N / 2>::type> {};
+template <>
+struct make_index_sequence_of<0> { typedef index_sequence<> type; };
+template <>
+struct make_index_sequence_of<1> { typedef index_sequence<0> type; };
+
+template <std::size_t N>
+using make_index_sequence = typename make_index_sequence_of<N>::type;
+
+/**
+ * A tag for fixed-size vectors (colors, positions, IMU samples...) whose components have their own domains, given as tags or arithmetic types.
+ *
+ * Values are std::arrays, so all components must share the same value type. Domains are converted component-wise, with each pair of component domains converted as by domain_cast.
+ * For instance, a position with x and y between -1 and 1 and z between 0 and 1 is a vector_t<float11, float11, float01>, and domain_cast<vector_t<uint8_t, uint8_t, uint8_t>, vector_t<float11, float11, float01>>(position) converts it to bytes.
+ */
+template <typename... Tags>
+struct vector_t {};
+
+template <bool... Bs>
+struct all_of : std::is_same<all_of<Bs..., true>, all_of<true, Bs...>> {};
+
+template <typename Tag, typename... Tags>
+struct numeric_domain<vector_t<Tag, Tags...>> {
+	static_assert(all_of<std::is_same<value_type_of<Tag>, value_type_of<Tags>>::value...>::value, "the components of a vector_t must share the same value type");
+	typedef std::array<value_type_of<Tag>, 1 + sizeof...(Tags)> value_type;
+	static constexpr const value_type min() noexcept { return value_type{{numeric_domain<Tag>::min(), numeric_domain<Tags>::min()...}}; }
+	static constexpr const value_type max() noexcept { return value_type{{numeric_domain<Tag>::max(), numeric_domain<Tags>::max()...}}; }
+};
+
+template <typename T>
+struct is_vector_domain : std::false_type {};
+template <typename... Tags>
+struct is_vector_domain<vector_t<Tags...>> : std::true_type {};
+
 /**
  * dynamic_domain<T> provides runtime numeric bounds/range information for type T.
  * See static_domain<T> for a version where bounds are defined at compile time.
@@ -145,17 +414,17 @@ struct dynamic_domain {
 	typedef T value_type;
 	typedef decltype(std::declval<T>() - std::declval<T>()) extent_type;
 
-	dynamic_domain(value_type m, value_type M) : min(m), max(M) {}
+	constexpr dynamic_domain(value_type m, value_type M) noexcept : min(m), max(M) {}
 	value_type min;
 	value_type max;
-	extent_type extent() const { return static_cast<extent_type>(max) - static_cast<extent_type>(min); }
+	constexpr extent_type extent() const noexcept { return static_cast<extent_type>(max) - static_cast<extent_type>(min); }
 };
 
 /**
  * Create a dynamic domain with the given bounds.
  */
 template <typename T>
-dynamic_domain<T> make_domain(T min, T max) {
+constexpr dynamic_domain<T> make_domain(T min, T max) noexcept {
 	return dynamic_domain<T>(min, max);
 }
 
@@ -163,49 +432,365 @@ dynamic_domain<T> make_domain(T min, T max) {
  * Create a dynamic domain based on the static information given by arithmetic type or tag class T.
  */
 template <typename T>
-dynamic_domain<value_type_of<T>> make_domain() {
+constexpr dynamic_domain<value_type_of<T>> make_domain() noexcept {
 	return dynamic_domain<value_type_of<T>>(numeric_domain<T>::min(), numeric_domain<T>::max());
 }
 
-// Using a functor here should allow an optimization when casting between the same type (partial function template specialization isn't allowed).
+/**
+ * Whether numeric_domain<T> contains every value of value_type_of<T>, as with uint8_t or int16_t, or arithmetic_t<uint8_t>.
+ * Values of such domains never need to be clamped or wrapped.
+ */
+template <typename T>
+struct is_full_range : std::integral_constant<bool,
+	std::numeric_limits<value_type_of<T>>::is_integer
+	&& numeric_domain<T>::min() <= std::numeric_limits<value_type_of<T>>::min()
+	&& numeric_domain<T>::max() >= std::numeric_limits<value_type_of<T>>::max()> {};
+
+/**
+ * The policy actually applied when converting from numeric_domain<T> with Policy: bounding values of full-range domains is elided at compile time.
+ * unchecked is kept as is, since it also changes how the conversion is computed.
+ */
+template <typename T, typename Policy>
+using effective_policy = typename std::conditional<is_full_range<T>::value && !std::is_same<Policy, unchecked>::value, proven_in_range, Policy>::type;
+
+/**
+ * The type in which a conversion from numeric_domain<T> to numeric_domain<U> is computed.
+ */
+template <typename U, typename T>
+using computation_type_of = decltype((std::declval<value_type_of<T>>() - std::declval<value_type_of<T>>()) * std::declval<extent_type_of<U>>() / std::declval<extent_type_of<T>>());
+
+/**
+ * The extent of an integer numeric_domain<T>, computed with unsigned arithmetic so that it never overflows (unlike extent_of<int>()). Zero for floating-point domains.
+ */
+template <typename T, bool = std::is_integral<value_type_of<T>>::value>
+struct integer_extent : std::integral_constant<std::uintmax_t, 0> {};
+template <typename T>
+struct integer_extent<T, true> : std::integral_constant<std::uintmax_t, static_cast<std::uintmax_t>(numeric_domain<T>::max()) - static_cast<std::uintmax_t>(numeric_domain<T>::min())> {};
+
+/**
+ * The smallest integer type holding every value within an integer numeric_domain<T> (e.g. uint16_t for unsigned_int<12>, whose value type is int), or value_type_of<T> for other domains.
+ */
+template <typename T, bool = std::is_integral<value_type_of<T>>::value>
+struct compact_type {
+	typedef value_type_of<T> type;
+};
+template <typename T>
+struct compact_type<T, true> {
+	template <typename V>
+	using holds = std::integral_constant<bool, (numeric_domain<T>::min() < 0 ? static_cast<std::intmax_t>(numeric_domain<T>::min()) >= static_cast<std::intmax_t>(std::numeric_limits<V>::min()) : true)
+		&& static_cast<std::uintmax_t>(numeric_domain<T>::max()) <= static_cast<std::uintmax_t>(std::numeric_limits<V>::max())>;
+	template <typename V, typename Otherwise>
+	using either = typename std::conditional<holds<V>::value, V, Otherwise>::type;
+
+	typedef typename std::conditional<numeric_domain<T>::min() < 0,
+		either<std::int8_t, either<std::int16_t, either<std::int32_t, value_type_of<T>>>>,
+		either<std::uint8_t, either<std::uint16_t, either<std::uint32_t, value_type_of<T>>>>>::type type;
+};
+
+/**
+ * The extent of numeric_domain<T>, and the distance of a value within it from its minimum, converted to the (floating-point) computation type C.
+ * For integer domains, the extent is computed exactly with unsigned arithmetic first, so that it does not overflow for domains spanning their whole type (e.g. int32_t).
+ * The distance is computed with integers when their extent fits in the extent type, and in C otherwise (rather than in 64-bit integers, whose conversion to floating point would keep batch loops from being vectorized).
+ */
+template <typename C, typename T>
+constexpr C extent_in(std::true_type /* integral */) noexcept {
+	return static_cast<C>(integer_extent<T>::value);
+}
+template <typename C, typename T>
+constexpr C extent_in(std::false_type /* floating-point */) noexcept {
+	return static_cast<C>(extent_of<T>());
+}
+template <typename C, typename T>
+constexpr C extent_in() noexcept {
+	return extent_in<C,T>(std::is_integral<value_type_of<T>>());
+}
+template <typename C, typename T>
+constexpr C distance_in(const value_type_of<T> value, std::true_type /* integral */) noexcept {
+	return integer_extent<T>::value <= static_cast<std::uintmax_t>(std::numeric_limits<extent_type_of<T>>::max())
+		? static_cast<C>(value - numeric_domain<T>::min())
+		: static_cast<C>(value) - static_cast<C>(numeric_domain<T>::min());
+}
+template <typename C, typename T>
+constexpr C distance_in(const value_type_of<T> value, std::false_type /* floating-point */) noexcept {
+	return static_cast<C>(value - numeric_domain<T>::min());
+}
+
+/**
+ * The type in which an integer conversion from numeric_domain<T> to numeric_domain<U> is actually computed: computation_type_of<U,T>, unless the product of both extents would overflow it, in which case the widest integer type of the same signedness is used.
+ */
+template <typename U, typename T>
+using integer_computation_type_of = typename std::conditional<
+	(integer_extent<T>::value != 0 && integer_extent<U>::value > static_cast<std::uintmax_t>(std::numeric_limits<computation_type_of<U,T>>::max()) / integer_extent<T>::value),
+	typename std::conditional<std::is_signed<computation_type_of<U,T>>::value, std::intmax_t, std::uintmax_t>::type,
+	computation_type_of<U,T>>::type;
+
+/**
+ * How values are rescaled from numeric_domain<T> to numeric_domain<U>, chosen at compile time from the bounds of both domains.
+ *
+ *  - floating: conversions computed in floating point, as umin + (value - tmin) * uextent / textent.
+ *  - arithmetic: the same for integers, in integer_computation_type_of<U,T>.
+ *  - sign_flip: between a signed and an unsigned integer type of the same size, both full-range (e.g. int8_t and uint8_t, int16_t and uint16_t), the conversion is an XOR of the sign bit.
+ *  - offset: between integer domains of the same extent (e.g. signed_int<12> and unsigned_int<12>), the conversion is an addition.
+ *  - multiply: when the extent of an integer domain U is a multiple of the extent of T, the division vanishes.
+ *    Between unsigned domains whose bit widths are multiples of each other, this is bit replication, e.g. a multiplication by 257 from uint8_t to uint16_t, or by 17 from unsigned_int<4> to uint8_t.
+ *  - ratio: when the product of both extents would overflow even the widest integer type (e.g. between 64-bit domains), the ratio of the extents is reduced and applied like ratio_scale, which is exact as long as the reduced ratio is small enough.
+ *
+ * Shortcuts give exactly the same results as the arithmetic they replace (test.cpp checks it exhaustively).
+ * Bit replication between other widths (e.g. unsigned_int<5> to uint8_t) rounds differently (4 becomes 33 instead of 32), so it is not one of them.
+ */
+enum class rescaling { floating, arithmetic, sign_flip, offset, multiply, ratio };
+
+constexpr std::uintmax_t greatest_common_divisor(const std::uintmax_t a, const std::uintmax_t b) noexcept {
+	return b ? greatest_common_divisor(b, a % b) : a;
+}
+
+/**
+ * The ratio of the extents of integer domains U and T, reduced (with num and den members, like std::ratio, which cannot hold extents beyond std::intmax_t).
+ */
+template <typename U, typename T>
+struct extent_ratio {
+	static constexpr std::uintmax_t divisor = greatest_common_divisor(integer_extent<U>::value, integer_extent<T>::value) | (integer_extent<U>::value == 0 && integer_extent<T>::value == 0);
+	static constexpr std::uintmax_t num = integer_extent<U>::value / divisor;
+	static constexpr std::uintmax_t den = integer_extent<T>::value / divisor;
+};
+
+template <typename U, typename T>
+struct rescaling_of : std::integral_constant<rescaling,
+	!std::is_integral<value_type_of<T>>::value || !std::is_integral<value_type_of<U>>::value ? rescaling::floating
+	: is_full_range<T>::value && is_full_range<U>::value && sizeof(value_type_of<T>) == sizeof(value_type_of<U>) && std::is_signed<value_type_of<T>>::value != std::is_signed<value_type_of<U>>::value ? rescaling::sign_flip
+	: integer_extent<T>::value == integer_extent<U>::value ? rescaling::offset
+	: integer_extent<T>::value != 0 && integer_extent<U>::value % integer_extent<T>::value == 0 ? rescaling::multiply
+	: integer_extent<T>::value != 0 && (integer_extent<U>::value > static_cast<std::uintmax_t>(std::numeric_limits<integer_computation_type_of<U,T>>::max()) / integer_extent<T>::value)
+		&& extent_ratio<U,T>::num <= std::numeric_limits<std::uintmax_t>::max() / extent_ratio<U,T>::den ? rescaling::ratio
+	: rescaling::arithmetic> {};
+
+/**
+ * Rescale a value within numeric_domain<T> (already clamped, wrapped or assumed to be within it) to numeric_domain<U>.
+ */
+template <typename U, typename T>
+constexpr value_type_of<U> static_rescale(const value_type_of<T> value, std::integral_constant<rescaling, rescaling::floating>) noexcept {
+	static_assert(!integer_only || !std::is_floating_point<computation_type_of<U,T>>::value, "this conversion is computed in floating point, which NUMERIC_DOMAIN_INTEGER_ONLY forbids");
+	typedef computation_type_of<U,T> C;
+	return static_cast<value_type_of<U>>(numeric_domain<U>::min() + distance_in<C,T>(value, std::is_integral<value_type_of<T>>()) * extent_in<C,U>() / extent_in<C,T>());
+}
+template <typename U, typename T>
+constexpr value_type_of<U> static_rescale(const value_type_of<T> value, std::integral_constant<rescaling, rescaling::arithmetic>) noexcept {
+	return static_cast<value_type_of<U>>(static_cast<integer_computation_type_of<U,T>>(numeric_domain<U>::min())
+		+ (static_cast<integer_computation_type_of<U,T>>(value) - static_cast<integer_computation_type_of<U,T>>(numeric_domain<T>::min()))
+		* static_cast<integer_computation_type_of<U,T>>(integer_extent<U>::value) / static_cast<integer_computation_type_of<U,T>>(integer_extent<T>::value));
+}
+template <typename U, typename T>
+constexpr value_type_of<U> static_rescale(const value_type_of<T> value, std::integral_constant<rescaling, rescaling::sign_flip>) noexcept {
+	typedef typename std::make_unsigned<value_type_of<T>>::type bits;
+	return static_cast<value_type_of<U>>(static_cast<bits>(static_cast<bits>(value) ^ static_cast<bits>(bits(1) << (std::numeric_limits<bits>::digits - 1))));
+}
 template <typename U, typename T>
+constexpr value_type_of<U> static_rescale(const value_type_of<T> value, std::integral_constant<rescaling, rescaling::offset>) noexcept {
+	return static_cast<value_type_of<U>>(static_cast<integer_computation_type_of<U,T>>(numeric_domain<U>::min())
+		+ (static_cast<integer_computation_type_of<U,T>>(value) - static_cast<integer_computation_type_of<U,T>>(numeric_domain<T>::min())));
+}
+template <typename U, typename T>
+constexpr value_type_of<U> static_rescale(const value_type_of<T> value, std::integral_constant<rescaling, rescaling::ratio>) noexcept {
+	return static_cast<value_type_of<U>>(static_cast<std::uintmax_t>(numeric_domain<U>::min())
+		+ ratio_scale<extent_ratio<U,T>>(static_cast<std::uintmax_t>(value) - static_cast<std::uintmax_t>(numeric_domain<T>::min()), std::true_type()));
+}
+template <typename U, typename T>
+constexpr value_type_of<U> static_rescale(const value_type_of<T> value, std::integral_constant<rescaling, rescaling::multiply>) noexcept {
+	return static_cast<value_type_of<U>>(static_cast<integer_computation_type_of<U,T>>(numeric_domain<U>::min())
+		+ (static_cast<integer_computation_type_of<U,T>>(value) - static_cast<integer_computation_type_of<U,T>>(numeric_domain<T>::min()))
+		* static_cast<integer_computation_type_of<U,T>>(integer_extent<U>::value / integer_extent<T>::value));
+}
+
+/**
+ * Whether a std::ratio is small enough for the ratio arithmetic of exact_coefficients not to overflow.
+ */
+template <typename Ratio>
+struct is_small_ratio : std::integral_constant<bool, Ratio::num >= -65536 && Ratio::num <= 65536 && Ratio::den <= 1024> {};
+
+/**
+ * The bounds of numeric_domain<T> as std::ratio (lower and upper), when they are known exactly at compile time and small enough (see is_small_ratio):
+ * integer domains within [-65536, 65536], and arithmetic_t and rational_t floating-point tags.
+ */
+template <typename T, typename = void>
+struct exact_bounds : std::false_type {};
+template <typename T>
+struct exact_bounds<T, typename std::enable_if<std::is_integral<value_type_of<T>>::value
+	&& static_cast<std::intmax_t>(numeric_domain<T>::min()) >= -65536 && numeric_domain<T>::max() <= 65536>::type> : std::true_type {
+	typedef std::ratio<static_cast<std::intmax_t>(numeric_domain<T>::min())> lower;
+	typedef std::ratio<static_cast<std::intmax_t>(numeric_domain<T>::max())> upper;
+};
+template <typename T, std::intmax_t Min, std::uintmax_t Max, typename RatioScaler>
+struct exact_bounds<arithmetic_t<T, Min, Max, RatioScaler>, typename std::enable_if<std::is_floating_point<T>::value
+	&& Min >= -65536 && Min <= 65536 && Max <= 65536 && is_small_ratio<RatioScaler>::value>::type> : std::true_type {
+	typedef std::ratio_multiply<std::ratio<Min>, RatioScaler> lower;
+	typedef std::ratio_multiply<std::ratio<static_cast<std::intmax_t>(Max)>, RatioScaler> upper;
+};
+template <typename T, typename MinRatio, typename MaxRatio>
+struct exact_bounds<rational_t<T, MinRatio, MaxRatio>, typename std::enable_if<std::is_floating_point<T>::value
+	&& is_small_ratio<MinRatio>::value && is_small_ratio<MaxRatio>::value>::type> : std::true_type {
+	typedef typename MinRatio::type lower;
+	typedef typename MaxRatio::type upper;
+};
+
+/**
+ * The folded coefficients of the conversion from numeric_domain<T> to numeric_domain<U> as std::ratio (scale and offset), when the bounds of both domains are known exactly and those of T differ.
+ */
+template <typename U, typename T, bool = exact_bounds<U>::value && exact_bounds<T>::value>
+struct exact_coefficients : std::false_type {};
+template <typename U, typename T>
+struct exact_coefficients<U, T, true> : std::integral_constant<bool, !std::ratio_equal<typename exact_bounds<T>::lower, typename exact_bounds<T>::upper>::value> {
+	typedef std::ratio_subtract<typename exact_bounds<T>::upper, typename exact_bounds<T>::lower> source_extent;
+	typedef std::ratio_divide<std::ratio_subtract<typename exact_bounds<U>::upper, typename exact_bounds<U>::lower>, typename std::conditional<source_extent::num == 0, std::ratio<1>, source_extent>::type> scale;
+	typedef std::ratio_subtract<typename exact_bounds<U>::lower, std::ratio_multiply<typename exact_bounds<T>::lower, scale>> offset;
+};
+
+/**
+ * Conversions from numeric_domain<T> to numeric_domain<U> computed in floating point may be folded to value * folded_scale() + folded_offset(), with both coefficients known at compile time.
+ * This is what unchecked conversions do, as they need no clamping. Conversions computed with integers are left exact.
+ *
+ * When the bounds of both domains are known exactly (see exact_coefficients), both coefficients are computed with ratio arithmetic and rounded once.
+ * Otherwise, they are computed from the bounds, in the computation type.
+ */
+template <typename U, typename T>
+constexpr computation_type_of<U,T> folded_scale(std::true_type /* exact */) noexcept {
+	return ratio_value<computation_type_of<U,T>, typename exact_coefficients<U,T>::scale>(std::false_type());
+}
+template <typename U, typename T>
+constexpr computation_type_of<U,T> folded_scale(std::false_type /* inexact */) noexcept {
+	return extent_in<computation_type_of<U,T>, U>() / extent_in<computation_type_of<U,T>, T>();
+}
+template <typename U, typename T>
+constexpr computation_type_of<U,T> folded_scale() noexcept {
+	return folded_scale<U,T>(std::integral_constant<bool, exact_coefficients<U,T>::value>());
+}
+template <typename U, typename T>
+constexpr computation_type_of<U,T> folded_offset(std::true_type /* exact */) noexcept {
+	return ratio_value<computation_type_of<U,T>, typename exact_coefficients<U,T>::offset>(std::false_type());
+}
+template <typename U, typename T>
+constexpr computation_type_of<U,T> folded_offset(std::false_type /* inexact */) noexcept {
+	return static_cast<computation_type_of<U,T>>(numeric_domain<U>::min()) - static_cast<computation_type_of<U,T>>(numeric_domain<T>::min()) * folded_scale<U,T>();
+}
+template <typename U, typename T>
+constexpr computation_type_of<U,T> folded_offset() noexcept {
+	return folded_offset<U,T>(std::integral_constant<bool, exact_coefficients<U,T>::value>());
+}
+template <typename U, typename T>
+constexpr value_type_of<U> folded_domain_convert(const value_type_of<T> value, std::true_type /* floating-point */) noexcept {
+	static_assert(!integer_only || !std::is_floating_point<computation_type_of<U,T>>::value, "this conversion is computed in floating point, which NUMERIC_DOMAIN_INTEGER_ONLY forbids");
+	return static_cast<value_type_of<U>>(bound_value(unchecked(), value, numeric_domain<T>::min(), numeric_domain<T>::max()) * folded_scale<U,T>() + folded_offset<U,T>());
+}
+template <typename U, typename T>
+constexpr value_type_of<U> folded_domain_convert(const value_type_of<T> value, std::false_type /* integral */) noexcept {
+	return static_rescale<U,T>(bound_value(unchecked(), value, numeric_domain<T>::min(), numeric_domain<T>::max()), rescaling_of<U,T>());
+}
+
+/**
+ * Convert a value within numeric_domain<T> to numeric_domain<U>, with a given policy for values outside numeric_domain<T>.
+ */
+template <typename U, typename T, typename Policy>
+constexpr value_type_of<U> static_domain_cast(const value_type_of<T> value, std::false_type /* not unchecked */) noexcept {
+	return static_rescale<U,T>(bound_value(effective_policy<T,Policy>(), value, numeric_domain<T>::min(), numeric_domain<T>::max()), rescaling_of<U,T>());
+}
+template <typename U, typename T, typename Policy>
+constexpr value_type_of<U> static_domain_cast(const value_type_of<T> value, std::true_type /* unchecked */) noexcept {
+	return folded_domain_convert<U,T>(value, std::is_floating_point<computation_type_of<U,T>>());
+}
+template <typename U, typename T, typename Policy>
+constexpr value_type_of<U> static_domain_cast(const value_type_of<T> value) noexcept;
+
+/**
+ * Convert a vector within numeric_domain<vector_t<Ts...>> to numeric_domain<vector_t<Us...>>, component by component.
+ *
+ * Components are converted independently of each other in a single expression, which compilers can turn into a few SIMD instructions (SLP vectorization).
+ * When saturating, all components are first clamped by a loop of their own, which compilers turn into packed comparisons (or min and max instructions): clamped within the expression of each conversion, they branch on the bounds of each component instead.
+ */
+struct component_wise {};
+
+template <typename Policy, typename... Us, typename... Ts, std::size_t... Is>
+constexpr value_type_of<vector_t<Us...>> static_component_cast(const value_type_of<vector_t<Ts...>>& value, vector_t<Us...>, vector_t<Ts...>, index_sequence<Is...>) noexcept {
+	static_assert(sizeof...(Us) == sizeof...(Ts), "vectors must have the same number of components");
+	return value_type_of<vector_t<Us...>>{{static_domain_cast<Us,Ts,Policy>(value[Is])...}};
+}
+template <typename U, typename T, typename Policy>
+constexpr value_type_of<U> static_component_cast(const value_type_of<T>& value, std::false_type /* saturate */) noexcept {
+	return static_component_cast<Policy>(value, U(), T(), make_index_sequence<std::tuple_size<value_type_of<T>>::value>());
+}
+template <typename U, typename T, typename Policy>
+inline value_type_of<U> static_component_cast(const value_type_of<T>& value, std::true_type /* saturate */) noexcept {
+	const value_type_of<T> low = numeric_domain<T>::min(), high = numeric_domain<T>::max();
+	value_type_of<T> bounded;
+	for(std::size_t i = 0; i < bounded.size(); ++i) {
+		bounded[i] = bound_value(saturate(), value[i], low[i], high[i]);
+	}
+	return static_component_cast<proven_in_range>(bounded, U(), T(), make_index_sequence<std::tuple_size<value_type_of<T>>::value>());
+}
+template <typename U, typename T, typename Policy>
+constexpr value_type_of<U> static_domain_cast(const value_type_of<T> value, component_wise) noexcept {
+	return static_component_cast<U,T,Policy>(value, std::is_same<Policy, saturate>());
+}
+
+template <typename U, typename T, typename Policy>
+constexpr value_type_of<U> static_domain_cast(const value_type_of<T> value) noexcept {
+	return static_domain_cast<U,T,Policy>(value, typename std::conditional<is_vector_domain<T>::value, component_wise, std::is_same<Policy, unchecked>>::type());
+}
+
+// Using a functor here should allow an optimization when casting between the same type (partial function template specialization isn't allowed).
+template <typename U, typename T, typename Policy = saturate>
 struct domain_caster {
-	value_type_of<U> operator()(const value_type_of<T> value) {
-		return domain_convert(value, numeric_domain<T>::min(), numeric_domain<T>::max(), extent_of<T>(), numeric_domain<U>::min(), extent_of<U>());
+	constexpr value_type_of<U> operator()(const value_type_of<T> value) const noexcept {
+		return static_domain_cast<U,T,Policy>(value);
+	}
+};
+// Casting within the same domain only applies the policy (e.g. wraps phases around), and saturating returns values unchanged.
+template <typename U, typename Policy>
+struct domain_caster<U,U,Policy> {
+	constexpr value_type_of<U> operator()(const value_type_of<U> value) const noexcept {
+		return static_domain_cast<U,U,Policy>(value);
 	}
 };
 template <typename U>
-struct domain_caster<U,U> {
-	value_type_of<U> operator()(const value_type_of<U> value) {
+struct domain_caster<U,U,saturate> {
+	constexpr value_type_of<U> operator()(const value_type_of<U> value) const noexcept {
 		return value;
 	}
 };
 
 /**
  * Convert a value within numeric_domain<T> to numeric_domain<U>.
+ *
+ * Policy decides what happens to values outside numeric_domain<T>: saturate (the default) clamps them, wrap wraps them around, and unchecked assumes there are none.
  */
-template <typename U, typename T>
-value_type_of<U> domain_cast(const value_type_of<T>& value) {
-	return domain_caster<U,T>()(value);
+template <typename U, typename T, typename Policy = saturate>
+constexpr value_type_of<U> domain_cast(const value_type_of<T>& value) noexcept {
+	return domain_caster<U,T,Policy>()(value);
 }
-template <typename U, typename T>
-constexpr value_type_of<U> domain_cast(const value_type_of<T>&& value) {
-	return static_domain_convert(value, numeric_domain<T>::min(), numeric_domain<T>::max(), extent_of<T>(), numeric_domain<U>::min(), extent_of<U>());
+template <typename U, typename T, typename Policy = saturate>
+constexpr value_type_of<U> domain_cast(const value_type_of<T>&& value) noexcept {
+	return domain_caster<U,T,Policy>()(value);
 }
 
 /**
  * Convert a value within a given dynamic domain to another dynamic domain.
  */
 template <typename DynamicDomainTo, typename DynamicDomainFrom>
-const typename DynamicDomainTo::value_type domain_cast(const DynamicDomainTo to, const typename DynamicDomainFrom::value_type value, const DynamicDomainFrom from) {
+constexpr const typename DynamicDomainTo::value_type domain_cast(const DynamicDomainTo to, const typename DynamicDomainFrom::value_type value, const DynamicDomainFrom from) noexcept {
 	return domain_convert(value, from.min, from.max, from.extent(), to.min, to.extent());
 }
 
+/**
+ * Convert a value within a given dynamic domain to another dynamic domain, with a given policy (saturate, wrap or unchecked) for values outside the source domain.
+ */
+template <typename DynamicDomainTo, typename DynamicDomainFrom, typename Policy>
+constexpr const typename DynamicDomainTo::value_type domain_cast(const DynamicDomainTo to, const typename DynamicDomainFrom::value_type value, const DynamicDomainFrom from, Policy) noexcept {
+	return domain_convert<Policy>(value, from.min, from.max, from.extent(), to.min, to.extent());
+}
+
 /**
  * Convert a value within numeric_domain<T> to a given dynamic domain.
  */
 template <typename T, typename DynamicDomainTo>
-const typename DynamicDomainTo::value_type domain_cast(const DynamicDomainTo to, const value_type_of<T> value) {
+constexpr const typename DynamicDomainTo::value_type domain_cast(const DynamicDomainTo to, const value_type_of<T> value) noexcept {
 	return domain_convert(value, numeric_domain<T>::min(), numeric_domain<T>::max(), extent_of<T>(), to.min, to.extent());
 }
 
@@ -213,8 +798,596 @@ const typename DynamicDomainTo::value_type domain_cast(const DynamicDomainTo to,
  * Convert a value within a given dynamic domain to numeric_domain<U>.
  */
 template <typename U, typename DynamicDomainFrom>
-const value_type_of<U> domain_cast(const typename DynamicDomainFrom::value_type value, const DynamicDomainFrom from) {
+constexpr const value_type_of<U> domain_cast(const typename DynamicDomainFrom::value_type value, const DynamicDomainFrom from) noexcept {
 	return domain_cast(make_domain<U>(), value, from);
 }
 
+/**
+ * Unsigned 64-bit division by a divisor known only at run time, but used many times.
+ *
+ * The divisor is turned once into a magic multiplier and a shift (the libdivide algorithm, after Granlund and Montgomery), after which each division is a multiplication, a few shifts and an addition instead of a 20 to 90 cycle division instruction.
+ * Quotients are truncated, as with the / operator. Dividing by zero returns the dividend.
+ * Without 128-bit integer support (__int128), the / operator is used instead.
+ */
+class invariant_divider {
+public:
+	NUMERIC_DOMAIN_CONSTEXPR14 invariant_divider() noexcept : invariant_divider(1) {}
+
+	NUMERIC_DOMAIN_CONSTEXPR14 explicit invariant_divider(const std::uint64_t divisor) noexcept : divisor(divisor), magic(0), shift(0), add(false) {
+#if defined(__SIZEOF_INT128__)
+		if(divisor == 0) return;
+		unsigned floor_log2 = 63;
+		while(!(divisor >> floor_log2)) --floor_log2;
+		shift = static_cast<unsigned char>(floor_log2);
+		if((divisor & (divisor - 1)) == 0) return; // Powers of two are a shift.
+
+		const unsigned __int128 dividend = static_cast<unsigned __int128>(1) << (64 + floor_log2);
+		std::uint64_t proposed = static_cast<std::uint64_t>(dividend / divisor);
+		const std::uint64_t remainder = static_cast<std::uint64_t>(dividend % divisor);
+		if(divisor - remainder >= (static_cast<std::uint64_t>(1) << floor_log2)) {
+			// The multiplier needs 65 bits: keep the low 64 and add the dividend back in divide().
+			proposed += proposed;
+			const std::uint64_t twice_remainder = remainder + remainder;
+			if(twice_remainder >= divisor || twice_remainder < remainder) ++proposed;
+			add = true;
+		}
+		magic = proposed + 1;
+#endif
+	}
+
+	NUMERIC_DOMAIN_CONSTEXPR14 std::uint64_t divide(const std::uint64_t dividend) const noexcept {
+#if defined(__SIZEOF_INT128__)
+		if(!magic) return dividend >> shift;
+		const std::uint64_t high = static_cast<std::uint64_t>((static_cast<unsigned __int128>(magic) * dividend) >> 64);
+		return (add ? ((dividend - high) >> 1) + high : high) >> shift;
+#else
+		return divisor ? dividend / divisor : dividend;
+#endif
+	}
+
+private:
+	std::uint64_t divisor;
+	std::uint64_t magic;
+	unsigned char shift;
+	bool add;
+};
+
+/**
+ * Converts values within a given dynamic domain to another dynamic domain.
+ *
+ * The extents of both domains are computed once, when the caster is built, which makes it the functor of choice for converting many values between the same two dynamic domains.
+ * Between integer domains, the division by the source extent is also turned into an invariant_divider once, and arithmetic is done on unsigned 64-bit magnitudes.
+ * When the product of the extents of both domains does not fit in 64 bits (e.g. between 40-bit domains), products are computed on 128 bits instead (see multiply_divide), so that it cannot overflow.
+ * Policy decides what happens to values outside the source domain, as with domain_cast.
+ */
+template <typename DynamicDomainTo, typename DynamicDomainFrom, typename Policy = saturate>
+struct dynamic_domain_caster {
+	typedef typename DynamicDomainTo::value_type value_type;
+	typedef typename DynamicDomainFrom::value_type source_type;
+	typedef std::integral_constant<bool, std::is_integral<value_type>::value && std::is_integral<source_type>::value> is_integer;
+
+	NUMERIC_DOMAIN_CONSTEXPR14 dynamic_domain_caster(const DynamicDomainTo to, const DynamicDomainFrom from) noexcept : tmin(from.min), tmax(from.max), textent(from.extent()), umin(to.min), uextent(to.extent()), divider(is_integer::value ? magnitude(textent) : 1),
+		wide(is_integer::value && magnitude(uextent) != 0 && magnitude(textent) > std::numeric_limits<std::uint64_t>::max() / magnitude(uextent)) {}
+
+	NUMERIC_DOMAIN_CONSTEXPR14 value_type operator()(const source_type value) const noexcept {
+		return convert(value, is_integer());
+	}
+
+	source_type tmin;
+	source_type tmax;
+	typename DynamicDomainFrom::extent_type textent;
+	value_type umin;
+	typename DynamicDomainTo::extent_type uextent;
+	invariant_divider divider;
+	bool wide;
+
+private:
+	constexpr value_type convert(const source_type value, std::false_type) const noexcept {
+		return domain_convert<Policy>(value, tmin, tmax, textent, umin, uextent);
+	}
+	NUMERIC_DOMAIN_CONSTEXPR14 value_type convert(const source_type value, std::true_type) const noexcept {
+		// Same as domain_convert, with unsigned magnitudes: umin +/- (bounded - tmin) * |uextent| / |textent|, truncated.
+		const std::uint64_t distance = static_cast<std::uintmax_t>(bound_value(Policy(), value, tmin, tmax)) - static_cast<std::uintmax_t>(tmin);
+		const std::uint64_t quotient = wide ? multiply_divide(distance, magnitude(uextent), magnitude(textent)) : divider.divide(distance * magnitude(uextent));
+		return static_cast<value_type>(uextent < 0 ? static_cast<std::uintmax_t>(umin) - quotient : static_cast<std::uintmax_t>(umin) + quotient);
+	}
+};
+
+/**
+ * Create a caster converting values from one dynamic domain to another.
+ */
+template <typename DynamicDomainTo, typename DynamicDomainFrom>
+NUMERIC_DOMAIN_CONSTEXPR14 dynamic_domain_caster<DynamicDomainTo, DynamicDomainFrom> make_caster(const DynamicDomainTo to, const DynamicDomainFrom from) noexcept {
+	return dynamic_domain_caster<DynamicDomainTo, DynamicDomainFrom>(to, from);
+}
+template <typename DynamicDomainTo, typename DynamicDomainFrom, typename Policy>
+NUMERIC_DOMAIN_CONSTEXPR14 dynamic_domain_caster<DynamicDomainTo, DynamicDomainFrom, Policy> make_caster(const DynamicDomainTo to, const DynamicDomainFrom from, Policy) noexcept {
+	return dynamic_domain_caster<DynamicDomainTo, DynamicDomainFrom, Policy>(to, from);
+}
+
+/**
+ * Runtime domains of fixed-size vectors, with a dynamic domain per component: the dynamic counterpart of vector_t.
+ */
+template <typename T, std::size_t N>
+struct dynamic_vector_domain {
+	typedef std::array<T, N> value_type;
+
+	std::array<dynamic_domain<T>, N> components;
+};
+
+/**
+ * Create a dynamic vector domain from the dynamic domains of its components.
+ */
+template <typename T, typename... Ts>
+constexpr dynamic_vector_domain<T, 1 + sizeof...(Ts)> make_vector_domain(const dynamic_domain<T> first, const Ts... rest) noexcept {
+	return dynamic_vector_domain<T, 1 + sizeof...(Ts)>{{{first, rest...}}};
+}
+
+/**
+ * Converts vectors within a dynamic vector domain to another, with a dynamic_domain_caster per component.
+ */
+template <typename To, typename From, std::size_t N, typename Policy = saturate>
+struct dynamic_vector_caster {
+	typedef std::array<To, N> value_type;
+	typedef std::array<From, N> source_type;
+
+	std::array<dynamic_domain_caster<dynamic_domain<To>, dynamic_domain<From>, Policy>, N> components;
+
+	NUMERIC_DOMAIN_CONSTEXPR14 value_type operator()(const source_type& value) const noexcept {
+		value_type result = {};
+		for(std::size_t i = 0; i < N; ++i) {
+			result[i] = components[i](value[i]);
+		}
+		return result;
+	}
+};
+
+template <typename To, typename From, std::size_t N, typename Policy, std::size_t... Is>
+NUMERIC_DOMAIN_CONSTEXPR14 dynamic_vector_caster<To, From, N, Policy> make_vector_caster(const dynamic_vector_domain<To, N> to, const dynamic_vector_domain<From, N> from, Policy, index_sequence<Is...>) noexcept {
+	return dynamic_vector_caster<To, From, N, Policy>{{{dynamic_domain_caster<dynamic_domain<To>, dynamic_domain<From>, Policy>(to.components[Is], from.components[Is])...}}};
+}
+
+/**
+ * Create a caster converting vectors from one dynamic vector domain to another.
+ * Batch domain_cast overloads for dynamic domains use it, so they convert vectors too.
+ */
+template <typename To, typename From, std::size_t N>
+NUMERIC_DOMAIN_CONSTEXPR14 dynamic_vector_caster<To, From, N> make_caster(const dynamic_vector_domain<To, N> to, const dynamic_vector_domain<From, N> from) noexcept {
+	return make_vector_caster(to, from, saturate(), make_index_sequence<N>());
+}
+template <typename To, typename From, std::size_t N, typename Policy>
+NUMERIC_DOMAIN_CONSTEXPR14 dynamic_vector_caster<To, From, N, Policy> make_caster(const dynamic_vector_domain<To, N> to, const dynamic_vector_domain<From, N> from, Policy) noexcept {
+	return make_vector_caster(to, from, Policy(), make_index_sequence<N>());
+}
+
+/**
+ * Convert a vector within a dynamic vector domain to another, component by component.
+ */
+template <typename To, typename From, std::size_t N>
+NUMERIC_DOMAIN_CONSTEXPR14 std::array<To, N> domain_cast(const dynamic_vector_domain<To, N> to, const std::array<From, N> value, const dynamic_vector_domain<From, N> from) noexcept {
+	return make_caster(to, from)(value);
+}
+template <typename To, typename From, std::size_t N, typename Policy>
+NUMERIC_DOMAIN_CONSTEXPR14 std::array<To, N> domain_cast(const dynamic_vector_domain<To, N> to, const std::array<From, N> value, const dynamic_vector_domain<From, N> from, Policy) noexcept {
+	return make_caster(to, from, Policy())(value);
+}
+
+/**
+ * A view over Rank-dimensional strided data, in the spirit of std::mdspan.
+ *
+ * `extents[d]` is the number of elements along dimension d, and `strides[d]` the distance (in elements, not bytes) between two consecutive elements along that dimension.
+ * The last dimension is the innermost one: a row-major matrix with C columns has strides {C, 1}, and one of its columns is a 1-dimensional view with stride C.
+ */
+template <typename T, std::size_t Rank = 1>
+struct strided_view {
+	typedef T value_type;
+
+	T* data;
+	std::size_t extents[Rank];
+	std::ptrdiff_t strides[Rank];
+
+	NUMERIC_DOMAIN_CONSTEXPR14 std::size_t size() const noexcept {
+		std::size_t result = 1;
+		for(std::size_t d = 0; d < Rank; ++d) {
+			result *= extents[d];
+		}
+		return result;
+	}
+};
+
+/**
+ * Create a 1-dimensional view over count elements, each one stride elements apart from the previous one.
+ */
+template <typename T>
+constexpr strided_view<T> make_view(T* data, std::size_t count, std::ptrdiff_t stride = 1) noexcept {
+	return strided_view<T>{data, {count}, {stride}};
+}
+
+/**
+ * Create a 2-dimensional view over rows*columns elements.
+ */
+template <typename T>
+constexpr strided_view<T, 2> make_view(T* data, std::size_t rows, std::size_t columns, std::ptrdiff_t row_stride, std::ptrdiff_t column_stride = 1) noexcept {
+	return strided_view<T, 2>{data, {rows, columns}, {row_stride, column_stride}};
+}
+
+/**
+ * Create a 3-dimensional view over planes*rows*columns elements.
+ */
+template <typename T>
+constexpr strided_view<T, 3> make_view(T* data, std::size_t planes, std::size_t rows, std::size_t columns, std::ptrdiff_t plane_stride, std::ptrdiff_t row_stride, std::ptrdiff_t column_stride = 1) noexcept {
+	return strided_view<T, 3>{data, {planes, rows, columns}, {plane_stride, row_stride, column_stride}};
+}
+
+/**
+ * Size in bytes of the output of a batch conversion above which it is written with non-temporal (streaming) stores, which bypass the caches.
+ *
+ * Outputs much bigger than the last-level cache would otherwise evict the whole working set of the program while they are written, only to be evicted in turn before being read.
+ * Smaller outputs (e.g. the blocks of a real-time thread) are written with normal stores, so that they are in the cache for whoever reads them next.
+ * Define it before including this header to tune it to the host; 0 disables streaming stores.
+ */
+#if !defined(NUMERIC_DOMAIN_STREAMING_THRESHOLD)
+#define NUMERIC_DOMAIN_STREAMING_THRESHOLD (std::size_t(8) << 20)
+#endif
+
+/**
+ * Convert the contiguous values in [first, last) with the given caster, writing the results to out with normal stores.
+ *
+ * This is the loop every batch conversion ends up in, kept simple enough for the compiler to vectorize.
+ * Returns the end of the output range.
+ */
+template <typename T, typename U, typename Caster>
+NUMERIC_DOMAIN_CONSTEXPR14 U* cached_transform(const T* first, const T* last, U* out, Caster caster) noexcept {
+	for(; first != last; ++first, ++out) {
+		*out = caster(*first);
+	}
+	return out;
+}
+
+/**
+ * Whether outputs of type U can be written with streaming stores: arithmetic values, whose size divides 16 so that 16-byte stores hold whole values, on targets with SSE2.
+ */
+#if defined(NUMERIC_DOMAIN_SSE2)
+template <typename U>
+struct is_streamable : std::integral_constant<bool, std::is_arithmetic<U>::value && 16 % sizeof(U) == 0> {};
+#else
+template <typename U>
+struct is_streamable : std::false_type {};
+#endif
+
+/**
+ * Convert the contiguous values in [first, last) with the given caster, writing the results to out with streaming stores.
+ *
+ * Values are converted by chunks of 4 KiB with cached_transform (so the conversion is still vectorized) into a buffer on the stack, which stays in the L1 cache, then copied to out with non-temporal 16-byte stores.
+ * The source of the next chunk is prefetched meanwhile. The first values are written with normal stores until out is 16-byte aligned (it always is for the data() of an aligned_buffer), and so are the last ones, which do not fill a chunk.
+ * Returns the end of the output range.
+ */
+template <typename T, typename U, typename Caster>
+U* streaming_transform(const T* first, const T* last, U* out, Caster caster, std::false_type /* streamable */) noexcept {
+	return cached_transform(first, last, out, caster);
+}
+#if defined(NUMERIC_DOMAIN_SSE2)
+template <typename T, typename U, typename Caster>
+U* streaming_transform(const T* first, const T* last, U* out, Caster caster, std::true_type /* streamable */) noexcept {
+	static constexpr std::size_t chunk = 4096 / sizeof(U);
+	alignas(64) U buffer[chunk];
+
+	while(first != last && reinterpret_cast<std::uintptr_t>(out) % 16 != 0) {
+		*out++ = caster(*first++);
+	}
+	while(static_cast<std::size_t>(last - first) >= chunk) {
+		if(static_cast<std::size_t>(last - first) >= 2 * chunk) {
+			const char* next = reinterpret_cast<const char*>(first + chunk);
+			for(std::size_t byte = 0; byte < chunk * sizeof(T); byte += 64) {
+				_mm_prefetch(next + byte, _MM_HINT_T0);
+			}
+		}
+		cached_transform(first, first + chunk, buffer, caster);
+		const __m128i* from = reinterpret_cast<const __m128i*>(buffer);
+		__m128i* to = reinterpret_cast<__m128i*>(out);
+		for(std::size_t i = 0; i < chunk * sizeof(U) / 16; ++i) {
+			_mm_stream_si128(to + i, _mm_load_si128(from + i));
+		}
+		first += chunk;
+		out += chunk;
+	}
+	// Streaming stores are weakly ordered: make them visible before anything written afterwards (e.g. a flag telling another thread the output is ready).
+	_mm_sfence();
+	return cached_transform(first, last, out, caster);
+}
+#endif
+
+/**
+ * Convert the contiguous values in [first, last) with the given caster, writing the results to out.
+ *
+ * Outputs of at least NUMERIC_DOMAIN_STREAMING_THRESHOLD bytes are written with streaming_transform, and smaller ones with cached_transform.
+ * The caster must not throw.
+ * Returns the end of the output range.
+ */
+template <typename T, typename U, typename Caster>
+NUMERIC_DOMAIN_CONSTEXPR14 U* domain_transform(const T* first, const T* last, U* out, Caster caster) noexcept {
+	return NUMERIC_DOMAIN_STREAMING_THRESHOLD > 0 && is_streamable<U>::value && static_cast<std::size_t>(last - first) * sizeof(U) >= NUMERIC_DOMAIN_STREAMING_THRESHOLD
+		? streaming_transform(first, last, out, caster, is_streamable<U>())
+		: cached_transform(first, last, out, caster);
+}
+
+/**
+ * Convert the values of a strided view with the given caster, writing the results to another strided view of the same extents.
+ *
+ * Innermost dimensions which are laid out contiguously in both views are merged at run time, and contiguous runs go through the vectorizable loop above.
+ * Only the remaining strided runs are converted element by element (i.e., with gathers and scatters).
+ */
+template <typename T, typename U, std::size_t Rank, typename Caster>
+NUMERIC_DOMAIN_CONSTEXPR14 void domain_transform(const strided_view<T, Rank> from, const strided_view<U, Rank> to, Caster caster) noexcept {
+	for(std::size_t d = 0; d < Rank; ++d) {
+		assert(from.extents[d] == to.extents[d]);
+		if(from.extents[d] == 0) return;
+	}
+
+	// Merge innermost dimensions for as long as they follow each other in memory in both views.
+	std::size_t inner = from.extents[Rank - 1];
+	std::size_t outer_rank = Rank - 1;
+	while(outer_rank > 0
+		&& from.strides[outer_rank - 1] == from.strides[outer_rank] * static_cast<std::ptrdiff_t>(from.extents[outer_rank])
+		&& to.strides[outer_rank - 1] == to.strides[outer_rank] * static_cast<std::ptrdiff_t>(to.extents[outer_rank])) {
+		--outer_rank;
+		inner *= from.extents[outer_rank];
+	}
+
+	const std::ptrdiff_t from_step = from.strides[Rank - 1];
+	const std::ptrdiff_t to_step = to.strides[Rank - 1];
+	std::size_t index[Rank] = {};
+	for(;;) {
+		const T* source = from.data;
+		U* destination = to.data;
+		for(std::size_t d = 0; d < outer_rank; ++d) {
+			source += static_cast<std::ptrdiff_t>(index[d]) * from.strides[d];
+			destination += static_cast<std::ptrdiff_t>(index[d]) * to.strides[d];
+		}
+
+		if(from_step == 1 && to_step == 1) {
+			domain_transform(source, source + inner, destination, caster);
+		} else {
+			for(std::size_t i = 0; i < inner; ++i) {
+				destination[static_cast<std::ptrdiff_t>(i) * to_step] = caster(source[static_cast<std::ptrdiff_t>(i) * from_step]);
+			}
+		}
+
+		// Move on to the next innermost run.
+		std::size_t d = outer_rank;
+		for(;;) {
+			if(d == 0) return;
+			--d;
+			if(++index[d] < from.extents[d]) break;
+			index[d] = 0;
+		}
+	}
+}
+
+/**
+ * Convert the contiguous values in [first, last) within numeric_domain<T> to numeric_domain<U>, writing the results to out.
+ * Returns the end of the output range.
+ */
+template <typename U, typename T, typename Policy = saturate>
+NUMERIC_DOMAIN_CONSTEXPR14 value_type_of<U>* domain_cast(const value_type_of<T>* first, const value_type_of<T>* last, value_type_of<U>* out) noexcept {
+	return domain_transform(first, last, out, domain_caster<U,T,Policy>());
+}
+
+/**
+ * Convert the contiguous values in [first, last) within numeric_domain<T> to several domains at once, writing the results to one output per target domain.
+ *
+ * Each value is read and bounded (according to Policy) once, then rescaled to every target domain, instead of making one pass over the input per target domain.
+ * Each output holds what domain_cast would give, except that outputs within numeric_domain<T> itself are bounded too.
+ * For instance, domain_fan_out<int16_t, float01, uint8_t>(first, last, floats, bytes) fills floats and bytes from the same int16_t samples.
+ */
+template <typename T, typename... Us, typename Policy>
+NUMERIC_DOMAIN_CONSTEXPR14 void domain_fan_out(Policy, const value_type_of<T>* first, const value_type_of<T>* last, value_type_of<Us>*... outs) noexcept {
+	// Once bounded, values are known to be in range (unchecked conversions keep their folded computation instead).
+	typedef typename std::conditional<std::is_same<Policy, unchecked>::value, unchecked, proven_in_range>::type bounded_policy;
+	const std::size_t count = static_cast<std::size_t>(last - first);
+	for(std::size_t i = 0; i < count; ++i) {
+		const value_type_of<T> bounded = bound_value(effective_policy<T,Policy>(), first[i], numeric_domain<T>::min(), numeric_domain<T>::max());
+		const int expand[] = { 0, (outs[i] = static_domain_cast<Us,T,bounded_policy>(bounded), 0)... };
+		(void)expand;
+	}
+}
+template <typename T, typename... Us>
+NUMERIC_DOMAIN_CONSTEXPR14 void domain_fan_out(const value_type_of<T>* first, const value_type_of<T>* last, value_type_of<Us>*... outs) noexcept {
+	domain_fan_out<T, Us...>(saturate(), first, last, outs...);
+}
+
+/**
+ * The conversion to numeric_domain<U> of every value within an integer numeric_domain<T>.
+ *
+ * It is a literal type, so that a table can be computed at compile time and stored in read-only data, with no startup cost:
+ *
+ *     static constexpr domain_table<uint8_t, unsigned_int<4>> table = make_domain_table<uint8_t, unsigned_int<4>>();
+ *     uint8_t byte = table(nibble);
+ *
+ * Compilers evaluate constant expressions slowly: a table of 65536 values (from a 16-bit domain) takes seconds to compile.
+ */
+template <typename U, typename T>
+struct domain_table {
+	static_assert(std::is_integral<value_type_of<T>>::value, "domain tables need an integer source domain");
+
+	value_type_of<U> values[integer_extent<T>::value + 1];
+
+	static constexpr std::size_t size() noexcept { return integer_extent<T>::value + 1; }
+
+	/**
+	 * Look up the conversion of a value. Values outside numeric_domain<T> are clamped, like with domain_cast.
+	 */
+	constexpr value_type_of<U> operator()(const value_type_of<T> value) const noexcept {
+		return values[static_cast<std::uintmax_t>(bound_value(effective_policy<T, saturate>(), value, numeric_domain<T>::min(), numeric_domain<T>::max())) - static_cast<std::uintmax_t>(numeric_domain<T>::min())];
+	}
+};
+
+template <typename U, typename T, std::size_t... Is>
+constexpr domain_table<U,T> make_domain_table(index_sequence<Is...>) noexcept {
+	return domain_table<U,T>{{ domain_cast<U,T>(static_cast<value_type_of<T>>(static_cast<std::intmax_t>(numeric_domain<T>::min()) + static_cast<std::intmax_t>(Is)))... }};
+}
+
+/**
+ * Compute a domain_table, at compile time when used in a constant expression.
+ */
+template <typename U, typename T>
+constexpr domain_table<U,T> make_domain_table() noexcept {
+	return make_domain_table<U,T>(make_index_sequence<integer_extent<T>::value + 1>());
+}
+
+/**
+ * Convert the values of a strided view within numeric_domain<T> to numeric_domain<U>, writing the results to another strided view of the same extents.
+ */
+template <typename U, typename T, typename Policy = saturate, typename V, typename W, std::size_t Rank>
+NUMERIC_DOMAIN_CONSTEXPR14 void domain_cast(const strided_view<V, Rank> from, const strided_view<W, Rank> to) noexcept {
+	static_assert(std::is_same<typename std::remove_const<V>::type, value_type_of<T>>::value, "the source view must hold values of numeric_domain<T>");
+	static_assert(std::is_same<W, value_type_of<U>>::value, "the destination view must hold values of numeric_domain<U>");
+	domain_transform(from, to, domain_caster<U,T,Policy>());
+}
+
+/**
+ * Convert the contiguous values in [first, last) within a given dynamic domain to another dynamic domain, writing the results to out.
+ * Returns the end of the output range.
+ */
+template <typename DynamicDomainTo, typename DynamicDomainFrom>
+NUMERIC_DOMAIN_CONSTEXPR14 typename DynamicDomainTo::value_type* domain_cast(const DynamicDomainTo to, const typename DynamicDomainFrom::value_type* first, const typename DynamicDomainFrom::value_type* last, typename DynamicDomainTo::value_type* out, const DynamicDomainFrom from) noexcept {
+	return domain_transform(first, last, out, make_caster(to, from));
+}
+
+/**
+ * Convert the values of a strided view within a given dynamic domain to another dynamic domain, writing the results to another strided view of the same extents.
+ */
+template <typename DynamicDomainTo, typename DynamicDomainFrom, typename V, typename W, std::size_t Rank>
+NUMERIC_DOMAIN_CONSTEXPR14 void domain_cast(const DynamicDomainTo to, const strided_view<V, Rank> from_values, const strided_view<W, Rank> to_values, const DynamicDomainFrom from) noexcept {
+	domain_transform(from_values, to_values, make_caster(to, from));
+}
+
+/**
+ * Convert the contiguous values in [first, last) with the given caster, overwriting them with the results, which are no bigger (e.g. int32_t to float, or int16_t to uint8_t).
+ * Returns the beginning of the converted values, which start at the same address as first.
+ *
+ * Values are converted forwards, by blocks of 4 KiB copied to the stack: results of a block only overwrite the values of this block and the ones before it, which were read already.
+ * Blocks are copied with memcpy rather than accessed through both types, which would break strict aliasing; the copies stay in the L1 cache, and the conversion between them is vectorized like domain_transform.
+ */
+template <typename T, typename U, typename Caster>
+U* domain_transform_in_place(T* first, T* last, Caster caster) noexcept {
+	static_assert(sizeof(U) <= sizeof(T) && alignof(U) <= alignof(T), "values can only be converted in place to types which are no bigger");
+	static constexpr std::size_t block = 4096 / sizeof(T);
+	T from[block];
+	U to[block];
+	unsigned char* const converted = reinterpret_cast<unsigned char*>(first);
+	unsigned char* out = converted;
+	while(first != last) {
+		const std::size_t count = std::min<std::size_t>(static_cast<std::size_t>(last - first), block);
+		std::memcpy(from, first, count * sizeof(T));
+		cached_transform(static_cast<const T*>(from), from + count, to, caster);
+		std::memcpy(out, to, count * sizeof(U));
+		first += count;
+		out += count * sizeof(U);
+	}
+	return reinterpret_cast<U*>(converted);
+}
+
+/**
+ * Convert the contiguous values in [first, last) within numeric_domain<T> to numeric_domain<U> in place, which needs value_type_of<U> to be no bigger than value_type_of<T>.
+ * Returns the beginning of the converted values, which start at the same address as first: the memory of [first, last) then holds last - first values within numeric_domain<U>.
+ *
+ * For instance, domain_cast_in_place<float11, int32_t>(samples, samples + count) converts a buffer of int32_t samples to floats without a second buffer.
+ */
+template <typename U, typename T, typename Policy = saturate>
+value_type_of<U>* domain_cast_in_place(value_type_of<T>* first, value_type_of<T>* last) noexcept {
+	return domain_transform_in_place<value_type_of<T>, value_type_of<U>>(first, last, domain_caster<U,T,Policy>());
+}
+
+/**
+ * Convert the contiguous values in [first, last) within a given dynamic domain to another dynamic domain in place, which needs values of the latter to be no bigger.
+ * Returns the beginning of the converted values, which start at the same address as first.
+ */
+template <typename DynamicDomainTo, typename DynamicDomainFrom>
+typename DynamicDomainTo::value_type* domain_cast_in_place(const DynamicDomainTo to, typename DynamicDomainFrom::value_type* first, typename DynamicDomainFrom::value_type* last, const DynamicDomainFrom from) noexcept {
+	return domain_transform_in_place<typename DynamicDomainFrom::value_type, typename DynamicDomainTo::value_type>(first, last, make_caster(to, from));
+}
+
+
+/**
+ * The conversion from a dynamic domain to another, folded to a clamp between low and high, then a multiply-add: (value - low) * scale + origin.
+ *
+ * Coefficients are floating-point numbers (float, unless one of the domains holds a wider type), so that they can be interpolated: see domain_ramp.
+ * Values are brought back to the start of the source domain (low) before being scaled, rather than scaled then shifted by a folded offset, which would cancel catastrophically for domains far from zero compared to their extent (e.g. from 1000 to 1000.01).
+ * Results may differ from domain_cast in the last place, as with unchecked conversions between static domains.
+ */
+template <typename DynamicDomainTo, typename DynamicDomainFrom>
+struct domain_coefficients {
+	typedef typename DynamicDomainTo::value_type value_type;
+	typedef typename DynamicDomainFrom::value_type source_type;
+	typedef typename std::common_type<float, value_type, source_type>::type coefficient_type;
+
+	coefficient_type scale;
+	coefficient_type origin; // The value low converts to.
+	coefficient_type low;
+	coefficient_type high;
+
+	constexpr value_type operator()(const source_type value) const noexcept {
+		static_assert(!integer_only || !std::is_floating_point<coefficient_type>::value, "this conversion is computed in floating point, which NUMERIC_DOMAIN_INTEGER_ONLY forbids");
+		return static_cast<value_type>((bound_value(saturate(), static_cast<coefficient_type>(value), low, high) - low) * scale + origin);
+	}
+};
+
+/**
+ * Compute the coefficients of the conversion from a dynamic domain to another.
+ */
+template <typename DynamicDomainTo, typename DynamicDomainFrom>
+constexpr domain_coefficients<DynamicDomainTo, DynamicDomainFrom> make_coefficients(const DynamicDomainTo to, const DynamicDomainFrom from) noexcept {
+	typedef typename domain_coefficients<DynamicDomainTo, DynamicDomainFrom>::coefficient_type C;
+	static_assert(!integer_only || !std::is_floating_point<C>::value, "this conversion is computed in floating point, which NUMERIC_DOMAIN_INTEGER_ONLY forbids");
+	return {
+		static_cast<C>(to.extent()) / static_cast<C>(from.extent()),
+		static_cast<C>(to.min),
+		static_cast<C>(from.min),
+		static_cast<C>(from.max)
+	};
+}
+
+/**
+ * Convert the contiguous values in [first, last), writing the results to out, while the conversion moves from one pair of dynamic domains (start) to another (end).
+ *
+ * The coefficients of both conversions are interpolated linearly across the block: the value at index i is converted with the coefficients found (i + 1) / count of the way from start to end, so that the last one is converted with end.
+ * This avoids the zipper noise of switching domains at block boundaries, for the cost of a multiply-add per coefficient and value, and the loop is vectorized like domain_transform.
+ * Returns the end of the output range.
+ */
+template <typename DynamicDomainTo, typename DynamicDomainFrom>
+NUMERIC_DOMAIN_CONSTEXPR14 typename DynamicDomainTo::value_type* domain_ramp(const typename DynamicDomainFrom::value_type* first, const typename DynamicDomainFrom::value_type* last, typename DynamicDomainTo::value_type* out, const domain_coefficients<DynamicDomainTo, DynamicDomainFrom> start, const domain_coefficients<DynamicDomainTo, DynamicDomainFrom> end) noexcept {
+	typedef typename domain_coefficients<DynamicDomainTo, DynamicDomainFrom>::coefficient_type C;
+	const std::size_t count = static_cast<std::size_t>(last - first);
+	if(count == 0) return out;
+	const C step = C(1) / static_cast<C>(count);
+	const C scale_step = (end.scale - start.scale) * step;
+	const C origin_step = (end.origin - start.origin) * step;
+	const C low_step = (end.low - start.low) * step;
+	const C high_step = (end.high - start.high) * step;
+	// Values are counted with 32-bit integers, which (unlike 64-bit ones) are converted to floating point in vector registers, so longer blocks are ramped in several runs.
+	const std::size_t run = std::size_t(1) << 30;
+	for(std::size_t base = 0; base < count; base += run) {
+		const std::int32_t n = static_cast<std::int32_t>(std::min(count - base, run));
+		const C origin = static_cast<C>(base);
+		for(std::int32_t i = 0; i < n; ++i) {
+			// Interpolated from the start rather than accumulated, so that rounding errors do not build up along the block.
+			const C k = origin + static_cast<C>(i + 1);
+			const C low = start.low + low_step * k;
+			const C bounded = bound_value(saturate(), static_cast<C>(first[base + i]), low, start.high + high_step * k);
+			out[base + i] = static_cast<typename DynamicDomainTo::value_type>((bounded - low) * (start.scale + scale_step * k) + (start.origin + origin_step * k));
+		}
+	}
+	out[count - 1] = end(first[count - 1]);
+	return out + count;
+}
+
+/**
+ * Convert the contiguous values in [first, last), writing the results to out, while the conversion moves from one pair of dynamic domains (to_start, from_start) to another (to_end, from_end).
+ */
+template <typename DynamicDomainTo, typename DynamicDomainFrom>
+NUMERIC_DOMAIN_CONSTEXPR14 typename DynamicDomainTo::value_type* domain_ramp(const DynamicDomainTo to_start, const DynamicDomainTo to_end, const typename DynamicDomainFrom::value_type* first, const typename DynamicDomainFrom::value_type* last, typename DynamicDomainTo::value_type* out, const DynamicDomainFrom from_start, const DynamicDomainFrom from_end) noexcept {
+	return domain_ramp(first, last, out, make_coefficients(to_start, from_start), make_coefficients(to_end, from_end));
+}
+
 }
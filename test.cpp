@@ -1,15 +1,66 @@
 #include "numeric_domain.hpp"
+#include "domain_ring_buffer.hpp"
+#include "domain_autotune.hpp"
+#include "domain_preimage.hpp"
+#include "domain_time.hpp"
+#include "domain_quantized_array.hpp"
+#include "domain_view.hpp"
+#include "domain_reduce.hpp"
+#include "domain_aligned_buffer.hpp"
+#include "domain_denormals.hpp"
+#include "domain_byte_order.hpp"
+#include "domain_block_codec.hpp"
 
 using namespace numeric_domain;
 
 #include <iostream>
 #include <sstream>
+#include <fstream>
 #include <string>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <cmath>
+#if __cplusplus >= 202002L
+#include <ranges>
+#endif
+
+// Allocation tracking, used to check that conversions are real-time safe (see test_realtime_safety()).
+// Every allocation goes through malloc (interposed when using glibc) or operator new (replaced everywhere else).
+std::atomic<long> allocations(0);
+
+#if defined(__GLIBC__)
+extern "C" void* __libc_malloc(std::size_t size);
+extern "C" void* __libc_calloc(std::size_t count, std::size_t size);
+extern "C" void* __libc_realloc(void* pointer, std::size_t size);
+extern "C" void __libc_free(void* pointer);
+extern "C" void* malloc(std::size_t size) noexcept { ++allocations; return __libc_malloc(size); }
+extern "C" void* calloc(std::size_t count, std::size_t size) noexcept { ++allocations; return __libc_calloc(count, size); }
+extern "C" void* realloc(void* pointer, std::size_t size) noexcept { ++allocations; return __libc_realloc(pointer, size); }
+void* allocate(std::size_t size) { return malloc(size); }
+void deallocate(void* pointer) { __libc_free(pointer); }
+#else
+void* allocate(std::size_t size) { ++allocations; return std::malloc(size); }
+void deallocate(void* pointer) { std::free(pointer); }
+#endif
+
+void* operator new(std::size_t size) {
+	if(void* pointer = allocate(size ? size : 1)) return pointer;
+	throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) { return operator new(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocate(size ? size : 1); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate(size ? size : 1); }
+void operator delete(void* pointer) noexcept { deallocate(pointer); }
+void operator delete[](void* pointer) noexcept { deallocate(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { deallocate(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { deallocate(pointer); }
 
 template <typename T>
 std::string print_min_and_max_of_bounds() {
 	std::ostringstream oss;
-	oss << " (min: " << +numeric_domain<T>::min() << ", max: " << +numeric_domain<T>::max() << ") ";
+	oss << " (min: " << +::numeric_domain::numeric_domain<T>::min() << ", max: " << +::numeric_domain::numeric_domain<T>::max() << ") ";
 	return oss.str();
 }
 
@@ -32,6 +83,1164 @@ void convert(value_type_of<T> v) {
 
 #include <random>
 #include <vector>
+#include <thread>
+#include <list>
+#include <numeric>
+
+int failures = 0;
+
+void check(bool condition, const std::string& what) {
+	if(!condition) {
+		++failures;
+		std::cout << "FAILED: " << what << std::endl;
+	}
+}
+
+void test_batch() {
+	std::cout << "BATCH CONVERSIONS:" << std::endl << std::endl;
+
+	// Contiguous buffers.
+	std::vector<int16_t> samples(1000);
+	for(std::size_t i = 0; i < samples.size(); ++i) {
+		samples[i] = static_cast<int16_t>(i * 65 - 32768);
+	}
+	std::vector<float> converted(samples.size());
+	check(domain_cast<float11,int16_t>(samples.data(), samples.data() + samples.size(), converted.data()) == converted.data() + converted.size(), "contiguous batch returns the end of the output");
+	bool same = true;
+	for(std::size_t i = 0; i < samples.size(); ++i) {
+		same = same && converted[i] == domain_cast<float11,int16_t>(samples[i]);
+	}
+	check(same, "contiguous batch matches scalar domain_cast");
+
+	// Every third sample of a buffer, into a contiguous output.
+	std::vector<float> every_third(samples.size() / 3);
+	domain_cast<float11,int16_t>(make_view(samples.data(), every_third.size(), 3), make_view(every_third.data(), every_third.size()));
+	same = true;
+	for(std::size_t i = 0; i < every_third.size(); ++i) {
+		same = same && every_third[i] == domain_cast<float11,int16_t>(samples[i * 3]);
+	}
+	check(same, "strided source matches scalar domain_cast");
+
+	// A column out of a row-major 4x5 matrix, into a column of a row-major 4x2 matrix.
+	float matrix[4][5];
+	for(int r = 0; r < 4; ++r) {
+		for(int c = 0; c < 5; ++c) {
+			matrix[r][c] = -1.0f + 0.1f * (r * 5 + c);
+		}
+	}
+	uint8_t columns[4][2] = {};
+	domain_cast<uint8_t,float11>(make_view(&matrix[0][2], 4, 5), make_view(&columns[0][1], 4, 2));
+	std::cout << "column 2 of the matrix to uint8_t:";
+	same = true;
+	for(int r = 0; r < 4; ++r) {
+		std::cout << " " << +columns[r][1];
+		same = same && columns[r][1] == domain_cast<uint8_t,float11>(matrix[r][2]) && columns[r][0] == 0;
+	}
+	std::cout << std::endl;
+	check(same, "matrix column matches scalar domain_cast");
+
+	// A 3x4 sub-block of the matrix (rows are not contiguous) and the whole matrix (which collapses to one contiguous run).
+	uint8_t block[3][4];
+	domain_cast<uint8_t,float11>(make_view(&matrix[1][1], 3, 4, 5), make_view(&block[0][0], 3, 4, 4));
+	uint8_t whole[2][2][5];
+	domain_cast<uint8_t,float11>(make_view(&matrix[0][0], 2, 2, 5, 10, 5), make_view(&whole[0][0][0], 2, 2, 5, 10, 5));
+	same = true;
+	for(int r = 0; r < 3; ++r) {
+		for(int c = 0; c < 4; ++c) {
+			same = same && block[r][c] == domain_cast<uint8_t,float11>(matrix[r + 1][c + 1]);
+		}
+	}
+	for(int i = 0; i < 20; ++i) {
+		same = same && (&whole[0][0][0])[i] == domain_cast<uint8_t,float11>((&matrix[0][0])[i]);
+	}
+	check(same, "2D and 3D views match scalar domain_cast");
+
+	// Dynamic domains.
+	auto from = make_domain<int>(-500, 1500);
+	auto to = make_domain<uint16_t>(0, 4095);
+	int values[] = { -600, -500, 0, 700, 1500, 2000 };
+	uint16_t results[6];
+	domain_cast(to, values, values + 6, results, from);
+	uint16_t strided_results[3];
+	domain_cast(to, make_view(values, 3, 2), make_view(strided_results, 3), from);
+	std::cout << "dynamic int(-500,1500) to dynamic uint16_t(0,4095):";
+	same = true;
+	for(int i = 0; i < 6; ++i) {
+		std::cout << " " << values[i] << "->" << results[i];
+		same = same && results[i] == domain_cast(to, values[i], from);
+	}
+	std::cout << std::endl << std::endl;
+	for(int i = 0; i < 3; ++i) {
+		same = same && strided_results[i] == results[i * 2];
+	}
+	check(same, "dynamic batch matches scalar domain_cast");
+
+	// One source, several targets.
+	int sources[] = { -3000, -2048, -1, 0, 1000, 2047, 5000 };
+	float units[7];
+	uint8_t bytes[7];
+	int16_t words[7];
+	int bounded[7];
+	domain_fan_out<signed_int<12>, float01, uint8_t, int16_t, signed_int<12>>(sources, sources + 7, units, bytes, words, bounded);
+	uint8_t wrapped[7];
+	float wrapped_units[7];
+	domain_fan_out<signed_int<12>, uint8_t, float01>(wrap(), sources, sources + 7, wrapped, wrapped_units);
+	same = true;
+	for(int i = 0; i < 7; ++i) {
+		same = same && units[i] == domain_cast<float01,signed_int<12>>(sources[i]) && bytes[i] == domain_cast<uint8_t,signed_int<12>>(sources[i]) && words[i] == domain_cast<int16_t,signed_int<12>>(sources[i]);
+		same = same && bounded[i] == std::max(-2048, std::min(2047, sources[i]));
+		same = same && wrapped[i] == domain_cast<uint8_t,signed_int<12>,wrap>(sources[i]) && wrapped_units[i] == domain_cast<float01,signed_int<12>,wrap>(sources[i]);
+	}
+	check(same, "fan-out matches domain_cast for each target");
+}
+
+void test_policies() {
+	std::cout << "POLICIES:" << std::endl << std::endl;
+
+	// saturate is the default.
+	check(domain_cast<uint8_t,unsigned_int<12>,saturate>(6000) == domain_cast<uint8_t,unsigned_int<12>>(6000), "saturate is the default policy");
+	check(domain_cast<uint8_t,unsigned_int<12>>(-5) == 0 && domain_cast<uint8_t,unsigned_int<12>>(6000) == 255, "saturate clamps values");
+
+	// wrap: integers wrap modulo extent + 1, floating-point values modulo extent.
+	std::cout << "wrap 4096<uint12>, 4097<uint12>, -1<uint12> to uint12: " << domain_cast<unsigned_int<12>,arithmetic_t<int, 0, 4095>,wrap>(4096) << " " << domain_cast<unsigned_int<12>,arithmetic_t<int, 0, 4095>,wrap>(4097) << " " << domain_cast<unsigned_int<12>,arithmetic_t<int, 0, 4095>,wrap>(-1) << std::endl;
+	check(domain_cast<uint16_t,unsigned_int<12>,wrap>(4096) == 0 && domain_cast<uint16_t,unsigned_int<12>,wrap>(-1) == 65535, "wrap wraps integers around");
+	check(domain_cast<int8_t,signed_int<7>,wrap>(64) == -128 && domain_cast<int8_t,signed_int<7>,wrap>(-65 - 128) == domain_cast<int8_t,signed_int<7>>(63), "wrap wraps signed integers around");
+	check(domain_cast<uint8_t,int16_t,wrap>(5) == domain_cast<uint8_t,int16_t>(5), "wrap leaves values of full-range domains alone");
+	float phase = 0;
+	float phases[8];
+	for(int i = 0; i < 8; ++i, phase += 0.375f) {
+		phases[i] = domain_cast<float01,float01,wrap>(phase);
+	}
+	float wrapped[8];
+	std::cout << "phase accumulator wrapped to float11:";
+	domain_cast<float11,float01,wrap>(phases, phases + 8, wrapped);
+	const float wrapped_phases[8] = { 0, 0.375f, 0.75f, 0.125f, 0.5f, 0.875f, 0.25f, 0.625f };
+	bool same = true;
+	for(int i = 0; i < 8; ++i) {
+		same = same && phases[i] == wrapped_phases[i] && wrapped[i] == domain_cast<float11,float01>(wrapped_phases[i]);
+	}
+	check(same, "wrap wraps phases within their own domain");
+	const float unwrapped_phases[2] = { 1.25f, -0.75f };
+	float rewrapped_phases[2];
+	domain_cast<float01,float01,wrap>(unwrapped_phases, unwrapped_phases + 2, rewrapped_phases);
+	const int counter = 4100;
+	check(domain_cast<float01,float01,wrap>(unwrapped_phases[0]) == 0.25f && domain_cast<float01,float01,wrap>(1.25f) == 0.25f && rewrapped_phases[0] == 0.25f && rewrapped_phases[1] == 0.25f, "wrap within the same domain agrees for lvalues, rvalues and batches");
+	check(domain_cast<unsigned_int<12>,unsigned_int<12>,wrap>(counter) == 4 && domain_cast<unsigned_int<12>,unsigned_int<12>,wrap>(4100) == 4, "wrap within the same integer domain agrees for lvalues and rvalues");
+	float phase_values[8] = { 0, 0.375f, 0.75f, 1.125f, 1.5f, 1.875f, 2.25f, -0.25f };
+	same = true;
+	for(int i = 0; i < 8; ++i) {
+		float expected = domain_cast<float11,float01>(phase_values[i] - std::floor(phase_values[i]));
+		float actual = domain_cast<float11,float01,wrap>(phase_values[i]);
+		std::cout << " " << actual;
+		same = same && actual == expected;
+	}
+	std::cout << std::endl;
+	check(same, "wrap wraps floating-point values around");
+	check(domain_cast(make_domain(0, 99), 250, make_domain(0, 99), wrap()) == 50 && make_caster(make_domain(0, 99), make_domain(0, 99), wrap())(-1) == 99, "wrap works with dynamic domains");
+
+	// unchecked: exact for integer conversions, within one ulp for floating-point ones.
+	same = true;
+	for(int v = 0; v < 4096; ++v) {
+		same = same && domain_cast<uint8_t,unsigned_int<12>,unchecked>(v) == domain_cast<uint8_t,unsigned_int<12>>(v);
+		float fast = domain_cast<float01,unsigned_int<12>,unchecked>(v);
+		float exact = domain_cast<float01,unsigned_int<12>>(v);
+		same = same && std::fabs(fast - exact) <= std::numeric_limits<float>::epsilon() * exact;
+	}
+	for(int v = -32768; v < 32768; ++v) {
+		float fast = domain_cast<float11,int16_t,unchecked>(static_cast<int16_t>(v));
+		float exact = domain_cast<float11,int16_t>(static_cast<int16_t>(v));
+		same = same && std::fabs(fast - exact) <= std::numeric_limits<float>::epsilon();
+	}
+	check(same, "unchecked matches saturate within the source domain");
+	// Clamping is elided at compile time for domains covering every value of their type (see also codegen.cpp).
+	static_assert(is_full_range<uint8_t>::value && is_full_range<int16_t>::value && is_full_range<arithmetic_t<uint8_t>>::value, "full-range domains are detected");
+	static_assert(!is_full_range<unsigned_int<12>>::value && !is_full_range<arithmetic_t<uint8_t, 0, 100>>::value && !is_full_range<float>::value && !is_full_range<float01>::value, "bounded domains are not full-range");
+	static_assert(std::is_same<effective_policy<int16_t, saturate>, proven_in_range>::value && std::is_same<effective_policy<int16_t, wrap>, proven_in_range>::value, "clamping full-range domains is elided");
+	static_assert(std::is_same<effective_policy<unsigned_int<12>, saturate>, saturate>::value && std::is_same<effective_policy<int16_t, unchecked>, unchecked>::value, "other policies are left alone");
+
+	std::cout << "unchecked 0.5<float11> to float01: " << domain_cast<float01,float11,unchecked>(0.5f) << std::endl << std::endl;
+}
+
+// Check domain_cast<U,T> against domain_convert computed with long long, for every value of value_type_of<T> from numeric_domain<T>::min() - margin to numeric_domain<T>::max() + margin.
+template <typename U, typename T>
+bool matches_generic_conversion(long long margin) {
+	typedef value_type_of<T> V;
+	long long tmin = static_cast<long long>(::numeric_domain::numeric_domain<T>::min());
+	long long tmax = static_cast<long long>(::numeric_domain::numeric_domain<T>::max());
+	long long umin = static_cast<long long>(::numeric_domain::numeric_domain<U>::min());
+	long long umax = static_cast<long long>(::numeric_domain::numeric_domain<U>::max());
+	long long first = std::max(tmin - margin, static_cast<long long>(std::numeric_limits<V>::min()));
+	long long last = std::min(tmax + margin, static_cast<long long>(std::numeric_limits<V>::max()));
+	for(long long v = first; v <= last; ++v) {
+		V value = static_cast<V>(v);
+		long long reference = domain_convert(static_cast<long long>(value), tmin, tmax, tmax - tmin, umin, umax - umin);
+		if(domain_cast<U,T>(value) != static_cast<value_type_of<U>>(reference)) return false;
+	}
+	return true;
+}
+
+void test_rescalings() {
+	std::cout << "EXACT SHORTCUTS:" << std::endl << std::endl;
+
+	static_assert(rescaling_of<uint8_t,int8_t>::value == rescaling::sign_flip && rescaling_of<int16_t,uint16_t>::value == rescaling::sign_flip, "sign bit flips are detected");
+	static_assert(rescaling_of<unsigned_int<12>,signed_int<12>>::value == rescaling::offset, "offsets are detected");
+	static_assert(rescaling_of<uint16_t,uint8_t>::value == rescaling::multiply && rescaling_of<uint8_t,unsigned_int<4>>::value == rescaling::multiply, "bit replications are detected");
+	static_assert(rescaling_of<uint8_t,unsigned_int<5>>::value == rescaling::arithmetic && rescaling_of<uint8_t,uint16_t>::value == rescaling::arithmetic, "inexact shortcuts are not used");
+	static_assert(rescaling_of<float01,uint8_t>::value == rescaling::floating && rescaling_of<uint8_t,float01>::value == rescaling::floating, "floating-point conversions are left alone");
+	static_assert(rescaling_of<arithmetic_t<uint64_t, 0, 3000000000000000000>,arithmetic_t<uint64_t, 0, 3000000>>::value == rescaling::multiply && rescaling_of<arithmetic_t<uint64_t, 0, 3000000000000000000>,arithmetic_t<uint64_t, 0, 7000000>>::value == rescaling::ratio, "reduced ratios are used when the product of extents overflows");
+	check(domain_cast<arithmetic_t<uint64_t, 0, 3000000000000000000>,arithmetic_t<uint64_t, 0, 7000000>>(1234567) == 529100142857142857u, "reduced ratios are exact");
+
+	std::cout << "int8_t -> uint8_t (-128, -1, 0, 127): " << +domain_cast<uint8_t,int8_t>(-128) << " " << +domain_cast<uint8_t,int8_t>(-1) << " " << +domain_cast<uint8_t,int8_t>(0) << " " << +domain_cast<uint8_t,int8_t>(127) << std::endl;
+	std::cout << "uint8_t -> uint16_t (0, 1, 128, 255): " << domain_cast<uint16_t,uint8_t>(0) << " " << domain_cast<uint16_t,uint8_t>(1) << " " << domain_cast<uint16_t,uint8_t>(128) << " " << domain_cast<uint16_t,uint8_t>(255) << std::endl;
+	std::cout << "uint5 -> uint8_t (1, 4, 31): " << +domain_cast<uint8_t,unsigned_int<5>>(1) << " " << +domain_cast<uint8_t,unsigned_int<5>>(4) << " " << +domain_cast<uint8_t,unsigned_int<5>>(31) << std::endl << std::endl;
+
+	// Every shortcut gives the same results as the generic arithmetic, for every input (including out-of-range ones).
+	check(matches_generic_conversion<uint8_t,int8_t>(0) && matches_generic_conversion<int8_t,uint8_t>(0), "sign flip between int8_t and uint8_t is exact");
+	check(matches_generic_conversion<uint16_t,int16_t>(0) && matches_generic_conversion<int16_t,uint16_t>(0), "sign flip between int16_t and uint16_t is exact");
+	check(matches_generic_conversion<unsigned_int<12>,signed_int<12>>(100) && matches_generic_conversion<signed_int<7>,unsigned_int<7>>(100), "offsets between signed and unsigned tags are exact");
+	check(matches_generic_conversion<arithmetic_t<int16_t, 0, 2000>,arithmetic_t<int, -500, 1500>>(100), "offsets between arbitrary tags are exact");
+	check(matches_generic_conversion<uint16_t,uint8_t>(0) && matches_generic_conversion<uint8_t,unsigned_int<4>>(100) && matches_generic_conversion<unsigned_int<12>,unsigned_int<6>>(100), "bit replications are exact");
+	check(matches_generic_conversion<uint16_t,unsigned_int<8>>(100) && matches_generic_conversion<int16_t,int8_t>(0), "multiplications are exact");
+	check(matches_generic_conversion<uint8_t,unsigned_int<5>>(100) && matches_generic_conversion<uint8_t,uint16_t>(0) && matches_generic_conversion<int8_t,int16_t>(0), "generic integer conversions are exact");
+}
+
+// Check a dynamic_domain_caster between integer domains against domain_convert computed with long long, for every value from from.min - margin to from.max + margin.
+template <typename To, typename From>
+bool matches_generic_conversion(dynamic_domain<To> to, dynamic_domain<From> from, long long margin) {
+	auto caster = make_caster(to, from);
+	long long first = std::max(std::min<long long>(from.min, from.max) - margin, static_cast<long long>(std::numeric_limits<From>::min()));
+	long long last = std::min(std::max<long long>(from.min, from.max) + margin, static_cast<long long>(std::numeric_limits<From>::max()));
+	for(long long v = first; v <= last; ++v) {
+		long long reference = domain_convert(v, static_cast<long long>(from.min), static_cast<long long>(from.max), static_cast<long long>(from.max) - from.min, static_cast<long long>(to.min), static_cast<long long>(to.max) - to.min);
+		if(caster(static_cast<From>(v)) != static_cast<To>(reference)) return false;
+	}
+	return true;
+}
+
+void test_invariant_division() {
+	std::cout << "INVARIANT DIVISION:" << std::endl << std::endl;
+
+	std::default_random_engine e(42);
+	std::uniform_int_distribution<uint64_t> any;
+	bool same = true;
+	uint64_t divisors[] = { 1, 2, 3, 5, 7, 10, 641, 2000, 4095, 65535, 1ull << 31, (1ull << 32) + 1, 0x7fffffffffffffffull, 0xffffffffffffffffull };
+	for(uint64_t d : divisors) {
+		invariant_divider divider(d);
+		uint64_t dividends[] = { 0, 1, d - 1, d, d + 1, 2 * d, 0xffffffffffffffffull, 0xfffffffffffffffeull };
+		for(uint64_t n : dividends) {
+			same = same && divider.divide(n) == n / d;
+		}
+		for(int i = 0; i < 10000; ++i) {
+			uint64_t n = any(e) >> (i % 64);
+			same = same && divider.divide(n) == n / d;
+		}
+	}
+	for(int i = 0; i < 10000; ++i) {
+		uint64_t d = (any(e) >> (i % 64)) | 1;
+		uint64_t n = any(e);
+		same = same && invariant_divider(d).divide(n) == n / d;
+	}
+	check(same, "invariant_divider truncates like the / operator");
+
+	auto from = make_domain<int>(-500, 1500);
+	auto to = make_domain<uint16_t>(0, 4095);
+	std::cout << "dynamic int(-500,1500) to dynamic uint16_t(0,4095) with a caster (-500, 0, 1499, 1500): " << make_caster(to, from)(-500) << " " << make_caster(to, from)(0) << " " << make_caster(to, from)(1499) << " " << make_caster(to, from)(1500) << std::endl << std::endl;
+	check(matches_generic_conversion(to, from, 1000), "integer dynamic_domain_caster matches domain_convert");
+	check(matches_generic_conversion(make_domain<int16_t>(100, -100), make_domain<int16_t>(-32768, 32767), 0), "integer dynamic_domain_caster matches domain_convert with a decreasing target domain");
+	check(matches_generic_conversion(make_domain<int8_t>(-128, 127), make_domain<uint16_t>(0, 65535), 0), "integer dynamic_domain_caster matches domain_convert from uint16_t to int8_t");
+	check(matches_generic_conversion(make_domain<uint32_t>(0, 0xffffffffu), make_domain<int>(-3, 40000), 100), "integer dynamic_domain_caster does not overflow");
+	check(make_caster(make_domain<int>(5, 10), make_domain<int>(7, 7))(8) == 5, "integer dynamic_domain_caster handles empty source domains");
+
+	// Products of extents wider than 64 bits.
+	const auto wide = make_domain<int64_t>(0, 1LL << 40);
+	const auto narrow = make_domain<int64_t>(-(1LL << 40), 1000);
+	const auto samples = make_domain<uint32_t>(0, 4000000000u);
+	std::cout << "dynamic int64_t(0,2^40) to itself, 2^39: " << make_caster(wide, wide)(1LL << 39) << " " << domain_cast(wide, int64_t(1LL << 39), wide) << std::endl << std::endl;
+	same = make_caster(wide, wide)(1LL << 39) == 1LL << 39 && domain_cast(wide, int64_t(1LL << 39), wide) == 1LL << 39;
+	same = same && make_caster(samples, samples)(3000000000u) == 3000000000u && domain_cast(samples, 3000000000u, samples) == 3000000000u;
+	for(int i = 0; i < 10000; ++i) {
+		const int64_t v = static_cast<int64_t>(any(e) >> 23) - (1LL << 40);
+		const uint32_t u = static_cast<uint32_t>(any(e));
+		const long double exact = (static_cast<long double>(std::min<int64_t>(v, 1000)) + (1LL << 40)) * (1LL << 40) / ((1LL << 40) + 1000);
+		same = same && make_caster(wide, narrow)(v) == domain_cast(wide, v, narrow) && std::fabs(static_cast<long double>(make_caster(wide, narrow)(v)) - exact) < 1;
+		same = same && make_caster(narrow, wide)(v) == domain_cast(narrow, v, wide);
+		same = same && make_caster(samples, samples)(u) == domain_cast(samples, u, samples) && make_caster(samples, samples)(u) == std::min(u, 4000000000u);
+	}
+	check(same, "integer dynamic conversions do not overflow when the product of extents needs more than 64 bits, and casters match domain_cast");
+}
+
+void test_ring_buffer() {
+	std::cout << "RING BUFFER:" << std::endl << std::endl;
+
+	// Single thread: convert on push, convert on pop, wrap around.
+	domain_ring_buffer<float11, 8> ring;
+	int16_t device[6] = { -32768, -16384, 0, 16384, 32767, 100 };
+	check(ring.push<int16_t>(device, 6) == 6, "ring buffer accepts a block that fits");
+	float half[4];
+	check(ring.pop(half, 4) == 4, "ring buffer pops what was pushed");
+	bool same = true;
+	for(int i = 0; i < 4; ++i) {
+		same = same && half[i] == domain_cast<float11,int16_t>(device[i]);
+	}
+	check(ring.push<int16_t>(device, 6) == 6 && ring.push<int16_t>(device, 6) == 0, "ring buffer refuses values when full");
+	uint8_t bytes[8];
+	check(ring.pop<uint8_t>(bytes, 10) == 8, "ring buffer pops across the wrap-around point");
+	std::cout << "int16_t pushed, uint8_t popped:";
+	for(int i = 0; i < 8; ++i) {
+		std::cout << " " << +bytes[i];
+		same = same && bytes[i] == domain_cast<uint8_t,float11>(domain_cast<float11,int16_t>(device[(i + 4) % 6]));
+	}
+	std::cout << std::endl << std::endl;
+	check(same, "ring buffer converts values on push and pop");
+
+	// Two threads: a producer pushing blocks of int16_t, a consumer popping floats.
+	static domain_ring_buffer<float11, 256> shared;
+	const int total = 100000;
+	std::thread producer([&]() {
+		int16_t block[64];
+		int sent = 0;
+		while(sent < total) {
+			int n = std::min(64, total - sent);
+			for(int i = 0; i < n; ++i) {
+				block[i] = static_cast<int16_t>((sent + i) % 65536 - 32768);
+			}
+			int pushed = 0;
+			while(pushed < n) {
+				pushed += static_cast<int>(shared.push<int16_t>(block + pushed, n - pushed));
+				if(pushed < n) std::this_thread::yield();
+			}
+			sent += n;
+		}
+	});
+	int received = 0;
+	same = true;
+	float block[48];
+	while(received < total) {
+		int n = static_cast<int>(shared.pop(block, 48));
+		for(int i = 0; i < n; ++i, ++received) {
+			same = same && block[i] == domain_cast<float11,int16_t>(static_cast<int16_t>(received % 65536 - 32768));
+		}
+		if(n == 0) std::this_thread::yield();
+	}
+	producer.join();
+	check(same, "ring buffer hands converted values over between threads, in order");
+}
+
+void test_autotune() {
+	std::cout << "AUTOTUNE:" << std::endl << std::endl;
+
+	const char* cache = "test_autotune.cache";
+	std::remove(cache);
+	domain_autotuner<float11, int16_t> tuner(cache);
+	std::cout << "int16_t to float11 strategy: " << (tuner.selected() == domain_autotuner<float11, int16_t>::strategy::table ? "table" : "arithmetic") << std::endl << std::endl;
+	std::vector<int16_t> samples;
+	for(int v = -32768; v <= 32767; ++v) samples.push_back(static_cast<int16_t>(v));
+	std::vector<float> floats(samples.size());
+	tuner(samples.data(), samples.data() + samples.size(), floats.data());
+	bool same = true;
+	for(std::size_t i = 0; i < samples.size(); ++i) {
+		same = same && floats[i] == domain_cast<float11,int16_t>(samples[i]) && tuner(samples[i]) == floats[i];
+	}
+	check(same, "autotuned conversions match domain_cast");
+
+	// Force each strategy through the cache file, out-of-range values included.
+	bool cached = true;
+	same = true;
+	const char* strategies[] = { "table", "arithmetic" };
+	for(const char* strategy : strategies) {
+		std::remove(cache);
+		std::ofstream(cache) << typeid(domain_caster<uint8_t, signed_int<10>>).name() << ' ' << strategy << '\n';
+		domain_autotuner<uint8_t, signed_int<10>> forced(cache);
+		cached = cached && (forced.selected() == domain_autotuner<uint8_t, signed_int<10>>::strategy::table) == (std::string(strategy) == "table");
+		for(int v = -2000; v <= 2000; ++v) {
+			same = same && forced(v) == domain_cast<uint8_t, signed_int<10>>(v);
+		}
+	}
+	std::remove(cache);
+	check(cached, "autotuner reads its decision from the cache file");
+	check(same, "both autotuner strategies match domain_cast");
+	check(domain_autotuner<int16_t, float11>().selected() == domain_autotuner<int16_t, float11>::strategy::arithmetic, "autotuner only tabulates integer domains of at most 16 bits");
+}
+
+// Whether filtering source values with the preimage of [low, high] selects exactly the values which convert within [low, high].
+template <typename V, typename W, typename Caster>
+bool preimage_filters_like(const std::vector<V>& values, Caster caster, const value_range<V> range, const W low, const W high) {
+	for(const V v : values) {
+		if(range.contains(v) != (caster(v) >= low && caster(v) <= high)) return false;
+	}
+	return true;
+}
+
+void test_preimage() {
+	std::cout << "PREDICATE PUSHDOWN:" << std::endl << std::endl;
+
+	std::vector<int16_t> samples;
+	for(int v = -32768; v <= 32767; ++v) samples.push_back(static_cast<int16_t>(v));
+	const value_range<int16_t> loud = domain_preimage<float01,int16_t>(std::nextafter(0.75f, 1.0f), 1.0f);
+	std::cout << "int16_t samples converted to more than 0.75 in float01: [" << loud.first << ", " << loud.last << "]" << std::endl;
+	bool same = preimage_filters_like(samples, domain_caster<float01,int16_t>(), loud, std::nextafter(0.75f, 1.0f), 1.0f);
+	const float thresholds[] = { -1.0f, 0.0f, 0.1f, 0.333f, 0.5f, 0.99999f, 1.0f, 2.0f };
+	for(const float low : thresholds) {
+		for(const float high : thresholds) {
+			same = same && preimage_filters_like(samples, domain_caster<float01,int16_t>(), domain_preimage<float01,int16_t>(low, high), low, high);
+		}
+	}
+	check(same, "static integer preimages are exact");
+
+	std::vector<int> wide;
+	for(int v = -10000; v <= 10000; ++v) wide.push_back(v);
+	wide.push_back(std::numeric_limits<int>::min());
+	wide.push_back(std::numeric_limits<int>::max());
+	same = preimage_filters_like(wide, domain_caster<uint8_t,signed_int<12>>(), domain_preimage<uint8_t,signed_int<12>>(0, 0), uint8_t(0), uint8_t(0));
+	same = same && preimage_filters_like(wide, domain_caster<uint8_t,signed_int<12>>(), domain_preimage<uint8_t,signed_int<12>>(255, 255), uint8_t(255), uint8_t(255));
+	same = same && preimage_filters_like(wide, domain_caster<uint8_t,signed_int<12>>(), domain_preimage<uint8_t,signed_int<12>>(100, 130), uint8_t(100), uint8_t(130));
+	check(same, "preimages extend to the lowest and highest values when they contain the bounds of the target domain");
+	check(domain_preimage<uint8_t,signed_int<12>>(130, 100).empty() && !domain_preimage<uint8_t,signed_int<12>>(130, 130).empty(), "empty target ranges have empty preimages");
+
+	std::vector<float> floats;
+	std::mt19937 random(42);
+	std::uniform_real_distribution<float> distribution(-1.5f, 1.5f);
+	for(int i = 0; i < 100000; ++i) floats.push_back(distribution(random));
+	const float specials[] = { -1.0f, 1.0f, 0.0f, -0.0f, std::nextafter(-1.0f, 0.0f), std::nextafter(1.0f, 0.0f), std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity() };
+	floats.insert(floats.end(), specials, specials + 8);
+	same = true;
+	for(const int low : { 0, 1, 100, 127, 128, 254, 255 }) {
+		for(const int high : { 0, 64, 127, 200, 255 }) {
+			same = same && preimage_filters_like(floats, domain_caster<uint8_t,float11>(), domain_preimage<uint8_t,float11>(static_cast<uint8_t>(low), static_cast<uint8_t>(high)), static_cast<uint8_t>(low), static_cast<uint8_t>(high));
+		}
+	}
+	check(same, "static floating-point preimages are exact");
+
+	const auto from = make_domain(-100.0f, 100.0f);
+	const auto to = make_domain<int16_t>(1000, -1000);
+	const value_range<float> decreasing = domain_preimage(to, int16_t(-10), int16_t(500), from);
+	std::cout << "dynamic float(-100,100) values converted within [-10, 500] of int16_t(1000,-1000): [" << decreasing.first << ", " << decreasing.last << "]" << std::endl;
+	check(!decreasing.empty() && preimage_filters_like(floats, make_caster(to, from), decreasing, int16_t(-10), int16_t(500)), "dynamic preimages handle decreasing domains");
+
+	std::vector<int16_t> selected(samples.size());
+	const std::size_t count = count_within(samples.data(), samples.data() + samples.size(), loud);
+	const int16_t* end = select_within(samples.data(), samples.data() + samples.size(), loud, selected.data());
+	same = count == static_cast<std::size_t>(end - selected.data()) && count == static_cast<std::size_t>(loud.last - loud.first + 1);
+	for(std::size_t i = 0; i < count; ++i) {
+		same = same && selected[i] == loud.first + static_cast<int>(i);
+	}
+	std::cout << "count of int16_t samples converted to more than 0.75: " << count << std::endl << std::endl;
+	check(same, "count_within and select_within filter source values");
+}
+
+// Batch conversion of a constant buffer, in a constant expression with C++14.
+NUMERIC_DOMAIN_CONSTEXPR14 int sum_of_converted() {
+	const int values[4] = { -600, 0, 700, 2000 };
+	uint16_t results[4] = {};
+	domain_cast(make_domain<uint16_t>(0, 4095), values, values + 4, results, make_domain<int>(-500, 1500));
+	return results[0] + results[1] + results[2] + results[3];
+}
+
+void test_constexpr() {
+	std::cout << "CONSTANT EXPRESSIONS:" << std::endl << std::endl;
+
+	constexpr auto from = make_domain<int>(-500, 1500);
+	constexpr auto to = make_domain<uint16_t>(0, 4095);
+	static_assert(from.extent() == 2000 && make_domain<uint8_t>().max == 255, "dynamic domains are constexpr");
+	static_assert(domain_convert(1500, -500, 1500, 2000, 0, 4095) == 4095, "domain_convert is constexpr");
+	constexpr int i = 700;
+	static_assert(domain_cast<uint8_t,signed_int<12>>(i) == domain_cast<uint8_t,signed_int<12>>(700), "lvalue domain_cast is constexpr");
+	static_assert(domain_caster<float01,uint8_t>()(255) == 1.0f, "domain_caster is constexpr");
+	static_assert(domain_cast(to, i, from) == 2457 && domain_cast<unsigned_int<12>>(to, 2047) == 2047 && domain_cast<uint8_t>(1500, from) == 255, "dynamic domain_cast is constexpr");
+
+	static constexpr domain_table<uint8_t, unsigned_int<4>> nibbles = make_domain_table<uint8_t, unsigned_int<4>>();
+	static_assert(nibbles.size() == 16 && nibbles(0) == 0 && nibbles(15) == 255 && nibbles(7) == domain_cast<uint8_t, unsigned_int<4>>(7), "domain tables are computed at compile time");
+	static_assert(nibbles(100) == 255 && nibbles(-1) == 0, "domain tables clamp values");
+	static constexpr domain_table<float11, signed_int<10>> samples = make_domain_table<float11, signed_int<10>>();
+	bool same = true;
+	for(int v = -600; v <= 600; ++v) {
+		same = same && samples(v) == domain_cast<float11,signed_int<10>>(v);
+	}
+	check(same, "domain tables match domain_cast");
+
+#if defined(__cpp_constexpr) && __cpp_constexpr >= 201304
+	static_assert(make_caster(to, from)(i) == domain_cast(to, i, from), "dynamic_domain_caster is constexpr with C++14");
+	static_assert(sum_of_converted() == 0 + 1023 + 2457 + 4095, "batch domain_cast is constexpr with C++14");
+#endif
+	check(sum_of_converted() == 0 + 1023 + 2457 + 4095, "batch domain_cast of constant buffers");
+}
+
+void test_ramp() {
+	std::cout << "RAMPS:" << std::endl << std::endl;
+
+	const auto from = make_domain(0.0f, 1.0f);
+	const auto to_start = make_domain(20.0f, 2000.0f);
+	const auto to_end = make_domain(100.0f, 8000.0f);
+	const auto coefficients = make_coefficients(to_start, from);
+	bool same = true;
+	for(float v = -0.5f; v <= 1.5f; v += 0.01f) {
+		same = same && std::fabs(coefficients(v) - domain_cast(to_start, v, from)) <= 1e-3f;
+	}
+	check(same, "domain_coefficients match domain_cast");
+
+	// Domains far from zero compared to their extent.
+	const auto narrow = make_domain(1000.0f, 1000.01f);
+	const auto unit = make_domain(0.0f, 1.0f);
+	const auto wide = make_domain(1e6f, 1e6f + 10);
+	float narrow_values[64];
+	float normalized[64];
+	for(int i = 0; i < 64; ++i) {
+		narrow_values[i] = 1000.0f + 0.01f * i / 63;
+	}
+	domain_ramp(unit, unit, narrow_values, narrow_values + 64, normalized, narrow, narrow);
+	same = true;
+	for(int i = 0; i < 64; ++i) {
+		const double exact = (static_cast<double>(narrow_values[i]) - 1000.0) / (static_cast<double>(1000.01f) - 1000.0);
+		same = same && std::fabs(normalized[i] - exact) <= 1e-5 && std::fabs(make_coefficients(unit, narrow)(narrow_values[i]) - exact) <= 1e-5;
+		same = same && std::fabs(make_coefficients(unit, wide)(1e6f + i / 8.0f) - i / 80.0) <= 1e-6;
+	}
+	check(same, "domain_coefficients and domain_ramp keep their precision far from zero");
+
+	// A constant control moving from one range to another across a block: outputs move steadily from one conversion to the other.
+	float control[64];
+	float ramped[64];
+	std::fill(control, control + 64, 0.5f);
+	check(domain_ramp(to_start, to_end, control, control + 64, ramped, from, from) == ramped + 64, "domain_ramp returns the end of the output");
+	std::cout << "0.5 ramped from (20,2000) to (100,8000) over 64 samples: " << ramped[0] << " " << ramped[31] << " " << ramped[63] << std::endl << std::endl;
+	same = ramped[63] == make_coefficients(to_end, from)(0.5f);
+	const float step = (domain_cast(to_end, 0.5f, from) - domain_cast(to_start, 0.5f, from)) / 64;
+	for(int i = 0; i < 64; ++i) {
+		same = same && std::fabs(ramped[i] - (domain_cast(to_start, 0.5f, from) + step * (i + 1))) <= 1e-2f;
+	}
+	check(same, "domain_ramp interpolates coefficients linearly and ends on the target conversion");
+
+	// Source bounds ramp too: out-of-range values are clamped to interpolated bounds.
+	int16_t samples[100];
+	int16_t clamped[100];
+	std::fill(samples, samples + 100, int16_t(150));
+	domain_ramp(make_domain<int16_t>(0, 100), make_domain<int16_t>(0, 200), samples, samples + 100, clamped, make_domain<int16_t>(0, 100), make_domain<int16_t>(0, 200));
+	same = true;
+	for(int i = 0; i < 100; ++i) {
+		same = same && clamped[i] == std::min(150, 100 + i + 1);
+	}
+	check(same, "domain_ramp interpolates the bounds of the source domain");
+}
+
+void test_vectors() {
+	std::cout << "VECTORS:" << std::endl << std::endl;
+
+	typedef vector_t<float11, float11, float01> position;
+	typedef vector_t<uint8_t, uint8_t, uint8_t> bytes;
+	static_assert(std::is_same<value_type_of<position>, std::array<float, 3>>::value, "vectors are std::arrays");
+	static_assert(::numeric_domain::numeric_domain<position>::min()[0] == -1.0f && ::numeric_domain::numeric_domain<position>::min()[2] == 0.0f && ::numeric_domain::numeric_domain<position>::max()[1] == 1.0f, "vector domains have per-component bounds");
+
+	const value_type_of<position> p = {{-0.5f, 2.0f, 0.25f}};
+	const value_type_of<bytes> b = domain_cast<bytes, position>(p);
+	std::cout << "(-0.5, 2, 0.25)<float11, float11, float01> to bytes: " << +b[0] << " " << +b[1] << " " << +b[2] << std::endl;
+	check(b[0] == domain_cast<uint8_t,float11>(p[0]) && b[1] == domain_cast<uint8_t,float11>(p[1]) && b[2] == domain_cast<uint8_t,float01>(p[2]), "vector domain_cast converts each component with its own domains");
+	const value_type_of<position> back = domain_cast<position, bytes>(value_type_of<bytes>{{0, 255, 51}});
+	check(back[0] == -1.0f && back[1] == 1.0f && back[2] == 0.2f, "vector domain_cast converts back");
+	const value_type_of<vector_t<unsigned_int<8>, unsigned_int<4>>> wrapped = domain_cast<vector_t<unsigned_int<8>, unsigned_int<4>>, vector_t<unsigned_int<4>, unsigned_int<4>>, wrap>(value_type_of<vector_t<unsigned_int<4>, unsigned_int<4>>>{{17, 3}});
+	check(wrapped[0] == 17 && wrapped[1] == 3, "vector domain_cast applies policies to each component");
+
+	value_type_of<position> positions[100];
+	value_type_of<bytes> converted[100];
+	for(int i = 0; i < 100; ++i) {
+		positions[i] = {{-1.5f + i * 0.03f, 1.0f - i * 0.02f, i * 0.01f}};
+	}
+	domain_cast<bytes, position>(positions, positions + 100, converted);
+	bool same = true;
+	for(int i = 0; i < 100; ++i) {
+		same = same && converted[i] == domain_cast<bytes, position>(positions[i]);
+	}
+	check(same, "batch vector domain_cast matches scalar domain_cast");
+
+	// An IMU sample with dynamic ranges per axis.
+	const auto imu = make_vector_domain(make_domain<int16_t>(-32768, 32767), make_domain<int16_t>(-32768, 32767), make_domain<int16_t>(0, 4095));
+	const auto unit = make_vector_domain(make_domain(-1.0f, 1.0f), make_domain(-1.0f, 1.0f), make_domain(0.0f, 1.0f));
+	const std::array<int16_t, 3> sample = {{-32768, 16384, 5000}};
+	const std::array<float, 3> normalized = domain_cast(unit, sample, imu);
+	std::cout << "(-32768, 16384, 5000) to dynamic unit vector: " << normalized[0] << " " << normalized[1] << " " << normalized[2] << std::endl << std::endl;
+	same = normalized[0] == domain_cast(make_domain(-1.0f, 1.0f), int16_t(-32768), make_domain<int16_t>(-32768, 32767)) && normalized[2] == 1.0f;
+	std::array<int16_t, 3> samples[10];
+	std::array<float, 3> normalized_samples[10];
+	for(int i = 0; i < 10; ++i) {
+		samples[i] = {{static_cast<int16_t>(i * 1000 - 5000), static_cast<int16_t>(i * 100), static_cast<int16_t>(i * 500)}};
+	}
+	domain_cast(unit, samples, samples + 10, normalized_samples, imu);
+	for(int i = 0; i < 10; ++i) {
+		same = same && normalized_samples[i] == domain_cast(unit, samples[i], imu);
+	}
+	check(same, "dynamic vector domain_cast converts each component with its own domains");
+}
+
+void test_time() {
+	std::cout << "TIME BASES:" << std::endl << std::endl;
+
+	typedef time_base<std::ratio<1, 48000>> samples_48k;
+	typedef time_base<std::ratio<1, 90000>> video_90k;
+	typedef time_base<std::nano> nanoseconds;
+	typedef time_base<std::micro> microseconds;
+	const std::uint64_t highest = std::numeric_limits<std::uint64_t>::max();
+
+	std::cout << "48000 samples at 48 kHz in nanoseconds: " << time_cast<nanoseconds, samples_48k>(48000) << std::endl;
+	std::cout << "2^64 - 1 nanoseconds in samples at 48 kHz: " << time_cast<samples_48k, nanoseconds>(highest) << std::endl << std::endl;
+	check(time_cast<nanoseconds, samples_48k>(48000) == 1000000000 && time_cast<nanoseconds, samples_48k>(1) == 20833, "time_cast scales ticks by the ratio of both periods, rounding down");
+	check(time_cast<microseconds, video_90k>(9) == 100 && time_cast<video_90k, microseconds>(100) == 9, "time_cast converts between 90 kHz and microseconds");
+	check(time_cast<nanoseconds, samples_48k>(highest) == highest && time_cast<nanoseconds, samples_48k>(885443715538059) == highest && time_cast<nanoseconds, samples_48k>(885443715538058) < highest, "time_cast saturates results beyond 64 bits");
+	check(time_cast<samples_48k, samples_48k>(highest) == highest, "time_cast between the same time bases is the identity");
+
+#if defined(__SIZEOF_INT128__)
+	// Compare with 128-bit arithmetic over the full range, in batches.
+	std::uint64_t ticks[1000];
+	std::uint64_t to_nanoseconds[1000];
+	std::uint64_t to_samples[1000];
+	std::uint64_t seed = 1;
+	for(std::uint64_t& t : ticks) {
+		seed = seed * 6364136223846793005u + 1442695040888963407u;
+		t = seed >> (seed % 64);
+	}
+	ticks[0] = highest;
+	ticks[1] = 0;
+	time_cast<nanoseconds, samples_48k>(ticks, ticks + 1000, to_nanoseconds);
+	time_cast<samples_48k, nanoseconds>(ticks, ticks + 1000, to_samples);
+	bool exact = true;
+	for(int i = 0; i < 1000; ++i) {
+		const unsigned __int128 nanoseconds_reference = static_cast<unsigned __int128>(ticks[i]) * 62500 / 3;
+		exact = exact && to_nanoseconds[i] == (nanoseconds_reference > highest ? highest : static_cast<std::uint64_t>(nanoseconds_reference));
+		exact = exact && to_samples[i] == static_cast<std::uint64_t>(static_cast<unsigned __int128>(ticks[i]) * 3 / 62500);
+		exact = exact && to_samples[i] == time_cast<samples_48k, nanoseconds>(ticks[i]);
+	}
+	check(exact, "time_cast is exact over the full 64-bit range");
+#endif
+
+	// Bounds of arithmetic_t are scaled by their RatioScaler without overflowing.
+	typedef arithmetic_t<std::uint64_t, 0, 300000000000000, std::ratio<62500, 3>> hours_in_nanoseconds;
+	static_assert(::numeric_domain::numeric_domain<hours_in_nanoseconds>::max() == 6250000000000000000u, "arithmetic_t bounds are scaled exactly");
+	check(domain_cast<hours_in_nanoseconds, arithmetic_t<std::uint64_t, 0, 300000000000000>>(150000000000000) == 3125000000000000000u, "domain_cast with large scaled bounds");
+}
+
+void test_rational() {
+	std::cout << "RATIONAL BOUNDS:" << std::endl << std::endl;
+
+	typedef rational_t<float, std::ratio<-1, 4>, std::ratio<3, 4>> quarters;
+	typedef rational_t<float, std::ratio<1, 3>, std::ratio<2>> third_to_two;
+	static_assert(::numeric_domain::numeric_domain<quarters>::min() == -0.25f && ::numeric_domain::numeric_domain<quarters>::max() == 0.75f, "rational bounds are exact");
+	static_assert(::numeric_domain::numeric_domain<third_to_two>::min() == 1.0f / 3.0f, "rational bounds are rounded once");
+	static_assert(exact_coefficients<float01, third_to_two>::value && !exact_coefficients<float01, float>::value, "exact coefficients are only used when both domains have exact bounds");
+	static_assert(folded_scale<float01, third_to_two>() == 0.6f && folded_offset<float01, third_to_two>() == -0.2f, "folded coefficients are computed exactly, then rounded once");
+	static_assert(folded_offset<float11, uint8_t>() == -1.0f && folded_scale<float11, int16_t>() == 2.0f / 65535.0f && folded_offset<float11, int16_t>() == 1.0f / 65535.0f, "folded coefficients of integer domains are exact");
+
+	std::cout << "0.25<[-0.25, 0.75]> to float01: " << domain_cast<float01, quarters>(0.25f) << std::endl;
+	std::cout << "1<[1/3, 2]> to float01: " << domain_cast<float01, third_to_two>(1.0f) << std::endl << std::endl;
+	check(domain_cast<float01, quarters>(0.25f) == 0.5f && domain_cast<uint8_t, quarters>(0.75f) == 255 && domain_cast<quarters, float11>(0.0f) == 0.25f, "rational domains convert like other static domains");
+	check(std::fabs(domain_cast<float01, third_to_two>(1.0f) - 0.4f) <= 1e-7f && domain_cast<third_to_two, float01>(1.0f) == 2.0f, "rational domains convert with non-integer bounds");
+	bool close = true;
+	for(int i = 0; i <= 1000; ++i) {
+		const float v = 1.0f / 3.0f + i * (5.0f / 3.0f) / 1000;
+		close = close && std::fabs(domain_cast<float01, third_to_two, unchecked>(v) - domain_cast<float01, third_to_two>(v)) <= 2 * std::numeric_limits<float>::epsilon();
+	}
+	check(close, "folded conversions from rational domains match exact ones");
+}
+
+void test_quantized_array() {
+	std::cout << "QUANTIZED ARRAYS:" << std::endl << std::endl;
+
+	typedef quantized_array<unsigned_int<12>, float01> array12;
+	static_assert(std::is_same<array12::stored_type, uint16_t>::value && std::is_same<compact_type<signed_int<9>>::type, int16_t>::value && std::is_same<compact_type<float01>::type, float>::value, "values are stored in the smallest type which holds them");
+	array12 a(1000);
+	for(std::size_t i = 0; i < a.size(); ++i) {
+		a[i] = i / 999.0f;
+	}
+	bool close = true;
+	for(std::size_t i = 0; i < a.size(); ++i) {
+		close = close && std::fabs(a[i] - i / 999.0f) <= 1.0f / 4095;
+	}
+	std::cout << "0.5 stored in 12 bits: " << a.data()[500] << ", read back as " << static_cast<float>(a[500]) << std::endl << std::endl;
+	check(close && a.data()[999] == 4095 && a.data()[0] == 0, "quantized_array encodes on write and decodes on read");
+
+	float values[1000];
+	float decoded[1000];
+	for(int i = 0; i < 1000; ++i) {
+		values[i] = 1.0f - i / 999.0f;
+	}
+	a.write(0, values, 1000);
+	a.read(0, 1000, decoded);
+	bool same = true;
+	for(int i = 0; i < 1000; ++i) {
+		same = same && a.data()[i] == domain_cast<unsigned_int<12>, float01>(values[i]) && decoded[i] == domain_cast<float01, unsigned_int<12>>(a.data()[i]) && decoded[i] == a[i];
+	}
+	check(same, "bulk read and write match scalar domain_cast");
+
+	const array12& constant = a;
+	float sum = 0;
+	for(const float v : constant) {
+		sum += v;
+	}
+	float copied[1000];
+	std::copy(constant.begin(), constant.end(), copied);
+	check(std::fabs(sum - 500.0f) < 1.0f && std::equal(copied, copied + 1000, decoded), "quantized_array iterators decode values");
+	std::fill(a.begin() + 10, a.begin() + 20, 0.5f);
+	a[0] = a[999];
+	check(a.data()[15] == 2047 && a[9] == decoded[9] && a[20] == decoded[20] && a.data()[0] == a.data()[999], "assignments through quantized_array iterators and references encode values");
+	check(a.cend() - a.cbegin() == 1000 && array12::const_iterator(a.begin() + 3) == a.cbegin() + 3, "quantized_array iterators are random-access");
+
+	quantized_array<uint8_t, float11> bytes(values, values + 1000);
+	check(bytes.size() == 1000 && bytes[0] == 1.0f && bytes[999] == domain_cast<float11, uint8_t>(127), "quantized_array is constructed from a range of values");
+}
+
+// Whether domain_view accepts a Range (as given by std::declval, so that plain types are temporaries).
+template <typename Range, typename = void>
+struct viewable : std::false_type {};
+template <typename Range>
+struct viewable<Range, decltype(void(domain_view<float11, int16_t>(std::declval<Range>())))> : std::true_type {};
+
+void test_views() {
+	std::cout << "VIEWS:" << std::endl << std::endl;
+
+	typedef decltype(domain_view<float11, int16_t>(std::declval<const std::vector<int16_t>&>())) view_type;
+	static_assert(viewable<std::vector<int16_t>&>::value && viewable<const std::vector<int16_t>&>::value && viewable<view_type>::value, "domain_view accepts sequences and temporary views");
+	static_assert(!viewable<std::vector<int16_t>>::value && !viewable<const std::vector<int16_t>>::value, "domain_view rejects temporary sequences, which would dangle");
+	static_assert(std::is_same<view_type::iterator::iterator_category, std::input_iterator_tag>::value, "converting iterators, which give prvalues, are input iterators");
+#if __cplusplus >= 202002L
+	static_assert(std::ranges::random_access_range<view_type> && std::random_access_iterator<view_type::iterator>, "C++20 algorithms see the category of the underlying iterator");
+#endif
+
+	std::vector<int16_t> samples(1000);
+	for(std::size_t i = 0; i < samples.size(); ++i) {
+		samples[i] = static_cast<int16_t>(i * 65 - 32768);
+	}
+	const auto floats = domain_view<float11, int16_t>(samples);
+	float sum = 0;
+	float expected = 0;
+	bool same = floats.size() == samples.size();
+	for(const float v : floats) {
+		sum += v;
+	}
+	for(std::size_t i = 0; i < samples.size(); ++i) {
+		expected += domain_cast<float11, int16_t>(samples[i]);
+		same = same && floats[i] == domain_cast<float11, int16_t>(samples[i]);
+	}
+	std::cout << "sum of 1000 int16_t samples viewed as float11: " << sum << std::endl << std::endl;
+	check(same && sum == expected && std::accumulate(floats.begin(), floats.end(), 0.0f) == expected, "domain_view converts elements on iteration");
+	check(std::distance(floats.begin(), floats.end()) == 1000 && floats.end() - floats.begin() == 1000, "views of random-access sequences keep their distances");
+
+	// Views of views compose their casters, and still go through the batch loop when the innermost sequence is contiguous.
+	const auto bytes = domain_view<uint8_t, float11>(domain_view<float11, int16_t>(samples));
+	static_assert(std::is_same<flattened<decltype(bytes.begin()), domain_caster<uint8_t, float11>>::base_type, const int16_t*>::value, "views of contiguous containers are flattened to pointers");
+	uint8_t converted[1000];
+	float converted_floats[1000];
+	check(bytes.copy_to(converted) == converted + 1000 && floats.copy_to(converted_floats) == converted_floats + 1000, "copy_to returns the end of the output");
+	same = true;
+	for(std::size_t i = 0; i < samples.size(); ++i) {
+		same = same && converted[i] == domain_cast<uint8_t, float11>(domain_cast<float11, int16_t>(samples[i])) && converted[i] == bytes[i] && converted_floats[i] == floats[i];
+	}
+	check(same, "copy_to converts chained views like iterating over them");
+
+	const std::list<int16_t> listed(samples.begin(), samples.begin() + 10);
+	std::vector<float> from_list;
+	domain_view<float11, int16_t>(listed).copy_to(std::back_inserter(from_list));
+	check(from_list.size() == 10 && std::equal(from_list.begin(), from_list.end(), converted_floats), "domain_view works with any sequence");
+
+	const int percents[] = {0, 25, 50, 100, 150};
+	const auto fractions = domain_view(make_domain(0.0f, 1.0f), percents, make_domain(0, 100));
+	check(fractions.size() == 5 && fractions[1] == 0.25f && fractions[4] == 1.0f && domain_view(make_domain(0.0f, 1.0f), percents, make_domain(0, 100), wrap())[4] == 0.49f, "domain_view converts between dynamic domains");
+}
+
+void test_reductions() {
+	std::cout << "REDUCTIONS:" << std::endl << std::endl;
+
+	static_assert(reduction_of<float11, int16_t>::value == reduction::integer_moments && reduction_of<float01, float11>::value == reduction::floating_moments && reduction_of<uint8_t, int16_t>::value == reduction::converted, "reductions are computed from source values when conversions are affine");
+
+	std::default_random_engine e(7);
+	std::uniform_int_distribution<int> any(-32768, 32767);
+	int16_t samples[1001];
+	float converted[1001];
+	for(int16_t& v : samples) {
+		v = static_cast<int16_t>(any(e));
+	}
+	samples[0] = -32768;
+	domain_cast<float11, int16_t>(samples, samples + 1001, converted);
+	double sum = 0;
+	double squares = 0;
+	float peak = 0;
+	for(const float v : converted) {
+		sum += v;
+		squares += static_cast<double>(v) * v;
+		peak = std::fabs(v) > std::fabs(peak) ? v : peak;
+	}
+	const double rms = std::sqrt(squares / 1001);
+	std::cout << "int16_t samples as float11: sum " << domain_sum<float11, int16_t>(samples, samples + 1001) << ", RMS " << domain_rms<float11, int16_t>(samples, samples + 1001) << ", peak " << domain_peak<float11, int16_t>(samples, samples + 1001) << std::endl << std::endl;
+	check(std::fabs(domain_sum<float11, int16_t>(samples, samples + 1001) - sum) < 1e-4 && std::fabs(domain_mean<float11, int16_t>(samples, samples + 1001) - sum / 1001) < 1e-7, "domain_sum and domain_mean match converting first");
+	check(std::fabs(domain_rms<float11, int16_t>(samples, samples + 1001) - rms) < 1e-7 && domain_peak<float11, int16_t>(samples, samples + 1001) == -1.0f, "domain_rms and domain_peak match converting first");
+
+	// Silence close to the zero of the target domain does not cancel out.
+	uint16_t silence[100];
+	std::fill(silence, silence + 100, uint16_t(32768));
+	check(std::fabs(domain_rms<float11, uint16_t>(silence, silence + 100) - 1.0 / 65535) < 1e-18, "domain_rms is accurate near zero");
+
+	float clipped[] = {-2.0f, -0.5f, 0.25f, 3.0f};
+	check(domain_sum<float01, float11>(clipped, clipped + 4) == 0.0 + 0.25 + 0.625 + 1.0 && domain_peak<float01, float11>(clipped, clipped + 4) == 1.0f, "reductions bound values outside the source domain");
+	check(domain_sum<uint8_t, float11>(clipped, clipped + 4) == 0.0 + 63 + 159 + 255 && std::fabs(domain_rms<uint8_t, float11>(clipped, clipped + 4) - std::sqrt((63.0 * 63 + 159.0 * 159 + 255.0 * 255) / 4)) < 1e-9, "reductions to integer domains round each value");
+	check(domain_sum<float11, int16_t>(samples, samples) == 0 && domain_rms<float11, int16_t>(samples, samples) == 0 && domain_peak<float11, int16_t>(samples, samples) == 0, "reductions of empty ranges are zero");
+
+	// Similarity between int8 embeddings and a float query, with per-dimension dynamic domains.
+	int8_t embedding[16];
+	float query[16];
+	domain_coefficients<dynamic_domain<float>, dynamic_domain<int8_t>> dimensions[16];
+	double expected = 0;
+	double expected_static = 0;
+	for(int i = 0; i < 16; ++i) {
+		embedding[i] = static_cast<int8_t>(i * 17 - 128);
+		query[i] = 0.1f * static_cast<float>(i) - 0.5f;
+		dimensions[i] = make_coefficients(make_domain(-0.5f - i * 0.1f, 0.5f + i * 0.1f), make_domain<int8_t>(-127, 127));
+		expected += static_cast<double>(dimensions[i](embedding[i]) * query[i]);
+		expected_static += static_cast<double>(domain_cast<float11, int8_t>(embedding[i])) * query[i];
+	}
+	check(std::fabs(domain_dot(dimensions, embedding, embedding + 16, query) - expected) < 1e-6, "domain_dot converts each dimension with its own coefficients");
+	check(std::fabs(domain_dot<float11, int8_t>(embedding, embedding + 16, query) - expected_static) < 1e-6, "domain_dot matches converting first");
+	const uint8_t weights[4] = {1, 2, 3, 4};
+	check(domain_dot<uint8_t, float11>(clipped, clipped + 4, weights) == 0.0 * 1 + 63 * 2 + 159 * 3 + 255 * 4, "domain_dot to integer domains rounds each value");
+
+	// Peaks of integer domains are compared without floating point, down to the most negative value.
+	const int64_t extremes[] = {5, std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max()};
+	check(domain_peak<int64_t, int64_t>(extremes, extremes + 3) == std::numeric_limits<int64_t>::min() && domain_peak<int8_t, int16_t>(samples, samples + 1001) == -128, "domain_peak compares integer magnitudes exactly");
+}
+
+void test_denormals() {
+	std::cout << "DENORMALS:" << std::endl << std::endl;
+
+	// A domain of tiny extent, to which every conversion is subnormal.
+	const auto tiny = make_domain(0.0f, 1e-38f);
+	const auto unit = make_domain(0.0f, 1.0f);
+	float values[] = {0.25f, 0.5f, 0.75f, 1.0f};
+	float plain[4];
+	float flushed[4];
+	domain_cast(tiny, values, values + 4, plain, unit);
+	domain_cast(tiny, values, values + 4, flushed, unit, flush_denormals());
+	check(std::fpclassify(plain[1]) == FP_SUBNORMAL && plain[3] == 1e-38f, "conversions produce subnormal numbers");
+	if(denormals_flushed::supported) {
+		check(flushed[0] == 0 && flushed[1] == 0 && flushed[2] == 0, "flush_denormals flushes subnormal results to zero");
+		{
+			const denormals_flushed scope;
+			domain_cast(tiny, values, values + 4, flushed, unit);
+			check(flushed[1] == 0, "denormals_flushed flushes subnormal results to zero");
+			{
+				const denormals_flushed nested;
+			}
+			domain_cast(tiny, values, values + 4, flushed, unit);
+			check(flushed[1] == 0, "nested denormals_flushed scopes restore the environment they found");
+		}
+	}
+	domain_cast(tiny, values, values + 4, flushed, unit);
+	check(std::equal(plain, plain + 4, flushed), "denormals_flushed restores the floating-point environment");
+
+	int16_t samples[] = {-32768, 0, 16384, 32767};
+	float floats[4];
+	domain_cast<float11, int16_t>(samples, samples + 4, floats, flush_denormals());
+	check(floats[0] == -1.0f && floats[3] == 1.0f, "flush_denormals converts between static domains");
+}
+
+void test_streaming() {
+	std::cout << "STREAMING STORES:" << std::endl << std::endl;
+
+	// Twice the threshold of output, so that batch conversions use streaming stores.
+	const std::size_t count = 2 * NUMERIC_DOMAIN_STREAMING_THRESHOLD / sizeof(float) + 37;
+	aligned_buffer<int16_t> samples(count);
+	aligned_buffer<float11> floats(count);
+	aligned_buffer<float11> pages(count, buffer_alignment::huge_page);
+	check(reinterpret_cast<std::uintptr_t>(samples.data()) % 64 == 0 && reinterpret_cast<std::uintptr_t>(floats.data()) % 64 == 0 && reinterpret_cast<std::uintptr_t>(pages.data()) % (std::size_t(2) << 20) == 0, "aligned_buffer aligns its values");
+	for(std::size_t i = 0; i < count; ++i) {
+		samples[i] = static_cast<int16_t>(i * 7919);
+	}
+
+	check(domain_cast<float11, int16_t>(samples.data(), samples.data() + count, floats.data()) == floats.data() + count, "streamed batch conversions return the end of the output");
+	bool same = true;
+	for(std::size_t i = 0; i < count; ++i) {
+		same = same && floats[i] == domain_cast<float11, int16_t>(samples[i]);
+	}
+	check(same, "streamed batch conversions match domain_cast");
+
+	// Misaligned outputs start with normal stores.
+	domain_cast<float11, int16_t>(samples.data() + 1, samples.data() + count, pages.data() + 1);
+	same = true;
+	for(std::size_t i = 1; i < count; ++i) {
+		same = same && pages[i] == floats[i];
+	}
+	check(same, "streamed batch conversions to misaligned outputs match domain_cast");
+
+	aligned_buffer<float11> moved(std::move(floats));
+	check(moved.size() == count && floats.empty() && moved[count - 1] == domain_cast<float11, int16_t>(samples[count - 1]), "aligned_buffer moves its values");
+}
+
+void test_in_place() {
+	std::cout << "IN-PLACE CONVERSIONS:" << std::endl << std::endl;
+
+	// Several blocks and a partial one.
+	const std::size_t count = 5000;
+	std::vector<int32_t> samples(count);
+	std::vector<int16_t> shorts(count);
+	std::default_random_engine e(11);
+	std::uniform_int_distribution<int32_t> any(std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max());
+	for(std::size_t i = 0; i < count; ++i) {
+		samples[i] = any(e);
+		shorts[i] = static_cast<int16_t>(samples[i] >> 16);
+	}
+
+	const int32_t full[] = {std::numeric_limits<int32_t>::min(), 0, 1 << 30, std::numeric_limits<int32_t>::max()};
+	check(domain_cast<float11, int32_t>(full[0]) == -1.0f && domain_cast<float11, int32_t>(full[1]) == 0.0f && domain_cast<float11, int32_t>(full[2]) == 0.5f && domain_cast<float11, int32_t>(full[3]) == 1.0f, "conversions from int32_t to floats do not overflow");
+
+	std::vector<float> expected(count);
+	domain_cast<float11, int32_t>(samples.data(), samples.data() + count, expected.data());
+	std::vector<int32_t> in_place = samples;
+	const float* floats = domain_cast_in_place<float11, int32_t>(in_place.data(), in_place.data() + count);
+	check(static_cast<const void*>(floats) == static_cast<const void*>(in_place.data()) && std::memcmp(floats, expected.data(), count * sizeof(float)) == 0, "domain_cast_in_place converts values of the same size");
+
+	std::vector<uint8_t> bytes(count);
+	domain_cast<uint8_t, int16_t>(shorts.data(), shorts.data() + count, bytes.data());
+	std::vector<int16_t> narrowed = shorts;
+	const uint8_t* narrow = domain_cast_in_place<uint8_t, int16_t>(narrowed.data(), narrowed.data() + count);
+	check(std::memcmp(narrow, bytes.data(), count) == 0, "domain_cast_in_place converts to narrower values");
+
+	const auto from = make_domain<int16_t>(-1000, 1000);
+	const auto to = make_domain<uint16_t>(0, 4095);
+	std::vector<uint16_t> dynamic(count);
+	domain_cast(to, shorts.data(), shorts.data() + count, dynamic.data(), from);
+	narrowed = shorts;
+	const uint16_t* converted = domain_cast_in_place(to, narrowed.data(), narrowed.data() + count, from);
+	check(std::memcmp(converted, dynamic.data(), count * sizeof(uint16_t)) == 0, "domain_cast_in_place converts between dynamic domains");
+}
+
+void test_byte_order() {
+	std::cout << "BYTE ORDER:" << std::endl << std::endl;
+
+	static_assert(swap_bytes(std::uint16_t(0x1234)) == 0x3412 && swap_bytes(std::uint32_t(0x12345678)) == 0x78563412 && swap_bytes(std::uint64_t(0x0123456789abcdef)) == 0xefcdab8967452301, "swap_bytes reverses bytes");
+
+	// Telemetry records of 7 bytes: a flag, a big-endian int16_t, then a big-endian 12-bit value in 16 bits and a little-endian one.
+	const int16_t levels[] = {-32768, -1, 16384, 32767, 1234};
+	const int readings[] = {0, 4095, 2048, 5000, 100};
+	unsigned char records[5 * 7 + 1];
+	for(int i = 0; i < 5; ++i) {
+		unsigned char* record = records + 1 + i * 7; // Misaligned on purpose.
+		record[0] = 0xff;
+		record[1] = static_cast<unsigned char>(static_cast<uint16_t>(levels[i]) >> 8);
+		record[2] = static_cast<unsigned char>(levels[i] & 0xff);
+		record[3] = static_cast<unsigned char>(readings[i] >> 8);
+		record[4] = static_cast<unsigned char>(readings[i] & 0xff);
+		record[5] = static_cast<unsigned char>(readings[i] & 0xff);
+		record[6] = static_cast<unsigned char>(readings[i] >> 8);
+	}
+
+	check(domain_cast<float11, big_endian<int16_t>>(records + 2) == -1.0f && domain_cast<float11, big_endian<int16_t>>(records + 1 + 3 * 7 + 1) == 1.0f, "scalar domain_cast reads big-endian values");
+	check(domain_cast<uint8_t, little_endian<unsigned_int<12>>>(records + 1 + 7 + 5) == 255 && domain_cast<uint8_t, big_endian<unsigned_int<12>>>(records + 1 + 7 + 3) == 255, "scalar domain_cast reads values in either byte order");
+
+	float floats[5];
+	uint8_t bytes[5];
+	uint8_t swapped[5];
+	check(domain_cast<float11, big_endian<int16_t>>(records + 2, 5, floats, 7) == floats + 5, "strided domain_cast returns the end of the output");
+	domain_cast<uint8_t, big_endian<unsigned_int<12>>>(records + 4, 5, bytes, 7);
+	domain_cast<uint8_t, little_endian<unsigned_int<12>>>(records + 6, 5, swapped, 7);
+	bool same = true;
+	for(int i = 0; i < 5; ++i) {
+		same = same && floats[i] == domain_cast<float11, int16_t>(levels[i]) && bytes[i] == domain_cast<uint8_t, unsigned_int<12>>(readings[i]) && swapped[i] == bytes[i];
+	}
+	check(same, "strided domain_cast converts fields of records");
+
+	// Packed big-endian samples, as in a network buffer, converted in one fused loop.
+	unsigned char packed[2 * 1000 + 1];
+	int16_t samples[1000];
+	float expected[1000];
+	float converted[1000];
+	for(int i = 0; i < 1000; ++i) {
+		samples[i] = static_cast<int16_t>(i * 65 - 32768);
+		packed[1 + 2 * i] = static_cast<unsigned char>(static_cast<uint16_t>(samples[i]) >> 8);
+		packed[2 + 2 * i] = static_cast<unsigned char>(samples[i] & 0xff);
+	}
+	domain_cast<float11, int16_t>(samples, samples + 1000, expected);
+	domain_cast<float11, big_endian<int16_t>>(packed + 1, 1000, converted);
+	check(std::equal(expected, expected + 1000, converted), "batch domain_cast reads packed big-endian values");
+}
+
+// Encode and decode values with a block_codec, and check that every decoded value is within half a step of its block (plus float rounding).
+template <unsigned Bits, std::size_t BlockSize>
+bool round_trips(const std::vector<float>& values, const double rounding = 1e-6) {
+	typedef block_codec<Bits, BlockSize> Codec;
+	std::vector<unsigned char> encoded(Codec::encoded_bytes(values.size()));
+	std::vector<float> decoded(values.size());
+	if(Codec::encode(values.data(), values.data() + values.size(), encoded.data()) != encoded.data() + encoded.size()) return false;
+	if(Codec::decode(encoded.data(), values.size(), decoded.data()) != decoded.data() + decoded.size()) return false;
+	for(std::size_t i = 0; i < values.size(); ++i) {
+		const dynamic_domain<float> block = Codec::domain(Codec::block(encoded.data(), i));
+		const double step = (static_cast<double>(block.max) - block.min) / ((1 << Bits) - 1);
+		if(!(std::fabs(static_cast<double>(decoded[i]) - values[i]) <= step * 0.501 + rounding)) return false;
+	}
+	return true;
+}
+
+void test_block_codec() {
+	std::cout << "BLOCK CODEC:" << std::endl << std::endl;
+
+	static_assert(block_codec<8>::block_bytes == 72 && block_codec<4, 256>::block_bytes == 136 && block_codec<3, 10>::payload_bytes == 4, "blocks hold a header and packed codes");
+	static_assert(block_codec<12, 256>::encoded_bytes(1000) == 4 * (8 + 384) && block_codec<12, 256>::encoded_bytes(0) == 0, "every block takes the same size");
+
+	// A noisy sine with a partial last block.
+	std::default_random_engine e(5);
+	std::uniform_real_distribution<float> noise(-0.01f, 0.01f);
+	std::vector<float> signal(1000);
+	for(std::size_t i = 0; i < signal.size(); ++i) {
+		signal[i] = 3.0f * std::sin(static_cast<float>(i) * 0.05f) + noise(e);
+	}
+	check(round_trips<8, 64>(signal) && round_trips<12, 256>(signal) && round_trips<16, 128>(signal) && round_trips<3, 10>(signal) && round_trips<1, 7>(signal), "block_codec decodes values within half a step");
+
+	// Blocks far from zero compared to their spread: decoded values are only further off by the rounding of floats around them (half a unit in the last place).
+	std::vector<float> offset(1000);
+	std::vector<float> far_offset(1000);
+	for(std::size_t i = 0; i < offset.size(); ++i) {
+		offset[i] = 1000.0f + 0.01f * static_cast<float>(i % 97) / 96;
+		far_offset[i] = 1e6f + 10.0f * static_cast<float>(i % 89) / 88;
+	}
+	check(round_trips<12, 64>(offset, 0.5 * (std::nextafter(1000.01f, 2000.0f) - 1000.01f)) && round_trips<8, 64>(far_offset, 0.5 * (std::nextafter(1e6f, 2e6f) - 1e6f)), "block_codec decodes blocks far from zero within half a step");
+
+	// Blocks whose step or spread overflows a float (tiny, subnormal, and near FLT_MAX spreads) are converted with doubles.
+	std::vector<float> tiny(256);
+	std::vector<float> subnormal(256);
+	std::vector<float> huge(256);
+	for(std::size_t i = 0; i < tiny.size(); ++i) {
+		tiny[i] = 1e-36f + 1e-36f * static_cast<float>(i % 61) / 60;
+		subnormal[i] = 1e-40f * static_cast<float>(i % 53);
+		huge[i] = i % 2 ? std::numeric_limits<float>::max() * (1.0f - static_cast<float>(i % 19) / 18) : -3e38f;
+	}
+	check(round_trips<16, 64>(tiny, 0.5 * (std::nextafter(2e-36f, 1.0f) - 2e-36f)) && round_trips<12, 64>(tiny, 0.5 * (std::nextafter(2e-36f, 1.0f) - 2e-36f)), "block_codec decodes blocks of tiny spread within half a step");
+	check(round_trips<16, 64>(subnormal, std::numeric_limits<float>::denorm_min()) && round_trips<1, 7>(subnormal, std::numeric_limits<float>::denorm_min()), "block_codec decodes blocks of subnormal spread within half a step");
+	check(round_trips<16, 64>(huge, 0.5 * (std::numeric_limits<float>::max() - std::nextafter(std::numeric_limits<float>::max(), 0.0f))) && round_trips<8, 100>(huge, 0.5 * (std::numeric_limits<float>::max() - std::nextafter(std::numeric_limits<float>::max(), 0.0f))), "block_codec decodes blocks spreading beyond FLT_MAX within half a step");
+
+	// Codes are packed least significant bits first, after a little-endian header.
+	const float pair[] = {-1.0f, 2.0f};
+	unsigned char encoded[block_codec<4, 2>::block_bytes];
+	block_codec<4, 2>::encode(pair, pair + 2, encoded);
+	check(encoded[3] == 0xbf && encoded[7] == 0x40 && encoded[8] == 0xf0, "block_codec writes a portable format");
+
+	// Constant blocks decode exactly, and blocks decode on their own.
+	std::vector<float> steps(300);
+	for(std::size_t i = 0; i < steps.size(); ++i) {
+		steps[i] = static_cast<float>(i / 64) * 0.1f;
+	}
+	std::vector<unsigned char> stored(block_codec<6>::encoded_bytes(steps.size()));
+	block_codec<6>::encode(steps.data(), steps.data() + steps.size(), stored.data());
+	float block[64];
+	block_codec<6>::decode_block(block_codec<6>::block(stored.data(), 200), 64, block);
+	check(block[0] == steps[192] && block[63] == steps[255] && block_codec<6>::domain(block_codec<6>::block(stored.data(), 299)).max == steps[299], "block_codec decodes any block on its own, and constant blocks exactly");
+}
+
+// Run f and return the number of allocations it made.
+template <typename F>
+long count_allocations(F f) {
+	long before = allocations.load();
+	f();
+	return allocations.load() - before;
+}
+
+void test_realtime_safety() {
+	std::cout << "REAL-TIME SAFETY:" << std::endl << std::endl;
+
+	check(count_allocations([]() { int* volatile p = new int(1); delete p; }) > 0, "allocation tracking detects operator new");
+	check(count_allocations([]() { void* volatile p = std::malloc(16); std::free(p); }) > 0, "allocation tracking detects malloc");
+
+	float f = 0.25f;
+	int i = 1300;
+	int16_t samples[64] = {};
+	float floats[64];
+	uint16_t integers[64];
+	auto from = make_domain<int>(-500, 1500);
+	auto to = make_domain<uint16_t>(0, 4095);
+
+	static_assert(noexcept(domain_cast<uint8_t,float01>(f)), "domain_cast is noexcept");
+	static_assert(noexcept(domain_cast<uint8_t,float01>(0.25f)), "constexpr domain_cast is noexcept");
+	static_assert(noexcept(domain_caster<float01,unsigned_int<12>>()(i)), "domain_caster is noexcept");
+	static_assert(noexcept(domain_cast(to, i, from)), "dynamic domain_cast is noexcept");
+	static_assert(noexcept(domain_cast<unsigned_int<12>>(to, i)), "static to dynamic domain_cast is noexcept");
+	static_assert(noexcept(domain_cast<unsigned_int<12>>(i, from)), "dynamic to static domain_cast is noexcept");
+	static_assert(noexcept(make_caster(to, from)(i)), "dynamic_domain_caster is noexcept");
+	static_assert(noexcept(domain_cast<float11,int16_t>(samples, samples + 64, floats)), "batch domain_cast is noexcept");
+	static_assert(noexcept(domain_cast<float11,int16_t>(make_view(samples, 32, 2), make_view(floats, 32))), "strided domain_cast is noexcept");
+	static_assert(noexcept(domain_cast(to, &i, &i + 1, integers, from)), "dynamic batch domain_cast is noexcept");
+	static_assert(noexcept(domain_fan_out<int16_t, float11, uint16_t>(samples, samples + 64, floats, integers)), "domain_fan_out is noexcept");
+	static_assert(noexcept(domain_ramp(to, to, &i, &i + 1, integers, from, from)), "domain_ramp is noexcept");
+	const std::array<float, 2> point = {{0.5f, -0.5f}};
+	const auto plane = make_vector_domain(make_domain(-1.0f, 1.0f), make_domain(-1.0f, 1.0f));
+	const auto pixels = make_vector_domain(make_domain<uint16_t>(0, 639), make_domain<uint16_t>(0, 479));
+	static_assert(noexcept(domain_cast<vector_t<uint8_t, uint8_t>, vector_t<float11, float11>>(point)), "vector domain_cast is noexcept");
+	static_assert(noexcept(domain_cast(pixels, point, plane)), "dynamic vector domain_cast is noexcept");
+	static quantized_array<unsigned_int<12>, float01> quantized(64);
+	static_assert(noexcept(quantized[0] = quantized[1]) && noexcept(quantized.read(0, 64, floats)) && noexcept(quantized.write(0, floats, 64)), "quantized_array accesses are noexcept");
+	const auto view = domain_view<float11, float11>(domain_view<float11, int16_t>(samples));
+	static_assert(noexcept(domain_rms<float11, int16_t>(samples, samples + 64)) && noexcept(domain_peak<float11, int16_t>(samples, samples + 64)) && noexcept(domain_dot<float11, int16_t>(samples, samples + 64, floats)), "reductions are noexcept");
+	std::uint64_t ticks[64] = {};
+	static_assert(noexcept(time_cast<time_base<std::nano>, time_base<std::ratio<1, 48000>>>(ticks, ticks + 64, ticks)), "time_cast is noexcept");
+	const value_range<int16_t> range = domain_preimage<float11,int16_t>(0.5f, 1.0f);
+	int16_t selected[64];
+	static_assert(noexcept(domain_preimage<float11,int16_t>(0.5f, 1.0f)), "domain_preimage is noexcept");
+	static_assert(noexcept(select_within(samples, samples + 64, range, selected)), "select_within is noexcept");
+
+	static domain_ring_buffer<float11, 128> ring;
+	static_assert(noexcept(ring.push<int16_t>(samples, 64)), "ring buffer push is noexcept");
+	static_assert(noexcept(ring.pop<uint16_t>(integers, 64)), "ring buffer pop is noexcept");
+
+	static aligned_buffer<int16_t> large(2 * NUMERIC_DOMAIN_STREAMING_THRESHOLD / sizeof(float));
+	static aligned_buffer<float11> streamed(large.size());
+	static_assert(noexcept(domain_cast<float11,int16_t>(large.data(), large.data() + large.size(), streamed.data())), "streamed batch domain_cast is noexcept");
+
+	static_assert(noexcept(denormals_flushed()) && noexcept(domain_cast<float11,int16_t>(samples, samples + 64, floats, flush_denormals())), "denormals_flushed scopes are noexcept");
+
+	static_assert(noexcept(domain_cast_in_place<uint16_t, int16_t>(samples, samples + 64)), "domain_cast_in_place is noexcept");
+
+	unsigned char packet[2 * 64 + 1] = {};
+	static_assert(noexcept(domain_cast<float11, big_endian<int16_t>>(packet + 1)) && noexcept(domain_cast<float11, big_endian<int16_t>>(packet + 1, 64, floats)), "byte-order domain_cast is noexcept");
+
+	unsigned char packed_block[block_codec<12>::block_bytes];
+	static_assert(noexcept(block_codec<12>::encode_block(floats, 64, packed_block)) && noexcept(block_codec<12>::decode_block(packed_block, 64, floats)), "block_codec is noexcept");
+
+	static domain_autotuner<float11, int16_t> tuner;
+	static_assert(noexcept(tuner(samples, samples + 64, floats)), "autotuned domain_cast is noexcept");
+
+	volatile float sink = 0;
+	long count = count_allocations([&]() {
+		sink = sink + domain_cast<uint8_t,float01>(f);
+		sink = sink + domain_cast<uint8_t,float01>(0.25f);
+		sink = sink + domain_cast<float01,unsigned_int<12>>(i);
+		sink = sink + domain_cast(to, i, from);
+		sink = sink + domain_cast<unsigned_int<12>>(to, i);
+		sink = sink + domain_cast<unsigned_int<12>>(i, from);
+		sink = sink + make_caster(to, from)(i);
+		domain_cast<float11,int16_t>(samples, samples + 64, floats);
+		domain_cast<float11,int16_t>(make_view(samples, 32, 2), make_view(floats, 32));
+		domain_cast<uint8_t,float11>(make_view(floats, 4, 4, 8, 4, 2, 1), make_view(reinterpret_cast<uint8_t*>(integers), 4, 4, 8, 32, 8, 1));
+		domain_cast(to, &i, &i + 1, integers, from);
+		domain_fan_out<int16_t, float11, uint16_t>(samples, samples + 64, floats, integers);
+		domain_ramp(to, to, &i, &i + 1, integers, from, from);
+		sink = sink + domain_cast<vector_t<uint8_t, uint8_t>, vector_t<float11, float11>>(point)[1] + domain_cast(pixels, point, plane)[0];
+		quantized[1] = f;
+		sink = sink + quantized[1];
+		quantized.write(0, floats, 64);
+		quantized.read(0, 64, floats);
+		sink = sink + view[3];
+		view.copy_to(floats);
+		sink = sink + static_cast<float>(domain_sum<float11, int16_t>(samples, samples + 64) + domain_rms<float11, int16_t>(samples, samples + 64) + domain_dot<float11, int16_t>(samples, samples + 64, floats)) + domain_peak<float11, int16_t>(samples, samples + 64);
+		time_cast<time_base<std::nano>, time_base<std::ratio<1, 48000>>>(ticks, ticks + 64, ticks);
+		sink = sink + domain_preimage<float11,int16_t>(0.5f, 1.0f).first + count_within(samples, samples + 64, range);
+		select_within(samples, samples + 64, range, selected);
+		ring.push<int16_t>(samples, 64);
+		ring.pop<uint16_t>(integers, 64);
+		tuner(samples, samples + 64, floats);
+		domain_cast<float11,int16_t>(large.data(), large.data() + large.size(), streamed.data());
+		domain_cast_in_place<uint16_t, int16_t>(samples, samples + 64);
+		sink = sink + domain_cast<float11, big_endian<int16_t>>(packet + 1);
+		domain_cast<float11, big_endian<int16_t>>(packet + 1, 64, floats);
+		block_codec<12>::encode_block(floats, 64, packed_block);
+		block_codec<12>::decode_block(packed_block, 64, floats);
+		{
+			const denormals_flushed scope;
+			domain_cast<float11,int16_t>(samples, samples + 64, floats, flush_denormals());
+		}
+	});
+	std::cout << "allocations in conversion hot paths: " << count << std::endl << std::endl;
+	check(count == 0, "conversion hot paths do not allocate");
+}
 
 int main(int argc, char** argv) {
 	std::random_device r;
@@ -67,6 +1276,29 @@ int main(int argc, char** argv) {
 	std::cout << "150<dynamic float(100,200)> to dynamic int8(-10, 50): " << +domain_cast(make_domain<int8_t>(-10, 50), 150, make_domain(100.0f, 200.0f)) << std::endl;
 	std::cout << "2047<static uint12> to dynamic float(100,200): " << +domain_cast<unsigned_int<12>>(make_domain(100.0f, 200.0f), 2047) << std::endl;
 	std::cout << "150<dynamic float(100,200)> to static uint12: " << +domain_cast<unsigned_int<12>>(150, make_domain(100.0f, 200.0f)) << std::endl;
+	std::cout << std::endl;
+
+	test_batch();
+	test_policies();
+	test_rescalings();
+	test_invariant_division();
+	test_ring_buffer();
+	test_autotune();
+	test_preimage();
+	test_constexpr();
+	test_ramp();
+	test_vectors();
+	test_time();
+	test_rational();
+	test_quantized_array();
+	test_views();
+	test_reductions();
+	test_denormals();
+	test_streaming();
+	test_in_place();
+	test_byte_order();
+	test_block_codec();
+	test_realtime_safety();
 
-	return 0;
+	return failures == 0 ? 0 : 1;
 }
\ No newline at end of file
@@ -0,0 +1,367 @@
+// Exhaustive accuracy and equivalence harness for the conversion paths of numeric_domain.
+//
+// For every pair of source and target domains below, every conversion path is compared with a reference implementation of domain_convert computed with long double.
+// Integer sources of at most 16 bits are enumerated exhaustively (with a margin of out-of-range values for tags); floating-point sources are densely sampled, plus boundary values.
+// The maximum error of each path is reported per pair, in LSB for integer targets and in ULP (of the largest magnitude of the target domain) for floating-point ones, and checked against a tolerance.
+//
+// Besides domain_cast (scalar, batch and unchecked) and dynamic_domain_caster, every pair checks fan-out, the coefficients of domain_coefficients and domain_ramp, in-place conversions (when the target type is no bigger), and reads from big-endian and little-endian bytes.
+// Integer sources also check the lookup tables of domain_autotuner (forced through its cache file), and, up to 12 bits, those of make_domain_table.
+//
+// Pairs are verified in parallel, on every available hardware thread. Run with `make accuracy`; pass -v to print every pair instead of a summary.
+
+#include "numeric_domain.hpp"
+#include "domain_autotune.hpp"
+#include "domain_byte_order.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <typeinfo>
+#include <vector>
+
+using namespace numeric_domain;
+
+template <typename... Ts>
+struct type_list {};
+
+using integer_sources = type_list<uint8_t, int8_t, uint16_t, int16_t,
+	unsigned_int<1>, unsigned_int<2>, unsigned_int<3>, unsigned_int<4>, unsigned_int<5>, unsigned_int<6>, unsigned_int<7>, unsigned_int<8>,
+	unsigned_int<9>, unsigned_int<10>, unsigned_int<11>, unsigned_int<12>, unsigned_int<13>, unsigned_int<14>, unsigned_int<15>, unsigned_int<16>,
+	signed_int<1>, signed_int<2>, signed_int<3>, signed_int<4>, signed_int<5>, signed_int<6>, signed_int<7>, signed_int<8>,
+	signed_int<9>, signed_int<10>, signed_int<11>, signed_int<12>, signed_int<13>, signed_int<14>, signed_int<15>, signed_int<16>>;
+using floating_sources = type_list<float01, float11, float_0_and_0_5>;
+using targets = type_list<float01, float11, float_0_and_0_5, uint8_t, int8_t, unsigned_int<7>, signed_int<7>, unsigned_int<12>, signed_int<12>, uint16_t, int16_t>;
+
+template <typename T> const char* value_type_name() { return std::is_floating_point<T>::value ? "float" : std::is_signed<T>::value ? "int" : "uint"; }
+
+template <typename T>
+std::string name() {
+	std::ostringstream oss;
+	oss << value_type_name<value_type_of<T>>() << (std::is_same<value_type_of<T>, int>::value ? "" : std::to_string(sizeof(value_type_of<T>) * 8)) << "[" << +::numeric_domain::numeric_domain<T>::min() << "," << +::numeric_domain::numeric_domain<T>::max() << "]";
+	return oss.str();
+}
+
+// Inputs of a source domain: all of them for integers, dense samples and boundary values for floating-point numbers.
+template <typename T>
+std::vector<value_type_of<T>> inputs(std::true_type /* integral */) {
+	typedef value_type_of<T> V;
+	const long long margin = 256;
+	long long first = std::max(static_cast<long long>(::numeric_domain::numeric_domain<T>::min()) - margin, static_cast<long long>(std::numeric_limits<V>::min()));
+	long long last = std::min(static_cast<long long>(::numeric_domain::numeric_domain<T>::max()) + margin, static_cast<long long>(std::numeric_limits<V>::max()));
+	std::vector<V> result;
+	for(long long v = first; v <= last; ++v) {
+		result.push_back(static_cast<V>(v));
+	}
+	result.push_back(std::numeric_limits<V>::min());
+	result.push_back(std::numeric_limits<V>::max());
+	return result;
+}
+template <typename T>
+std::vector<value_type_of<T>> inputs(std::false_type /* floating-point */) {
+	typedef value_type_of<T> V;
+	const V tmin = ::numeric_domain::numeric_domain<T>::min();
+	const V tmax = ::numeric_domain::numeric_domain<T>::max();
+	const V infinity = std::numeric_limits<V>::infinity();
+	std::vector<V> result;
+	const int samples = 1 << 20;
+	for(int i = 0; i <= samples; ++i) {
+		result.push_back(tmin - (tmax - tmin) / 4 + (tmax - tmin) * 1.5f * i / samples);
+	}
+	V boundaries[] = { tmin, tmax, (tmin + tmax) / 2, 0, -0.0f, std::numeric_limits<V>::denorm_min(), -std::numeric_limits<V>::denorm_min(), std::numeric_limits<V>::min(), -std::numeric_limits<V>::min(), std::numeric_limits<V>::max(), std::numeric_limits<V>::lowest(), infinity, -infinity, std::numeric_limits<V>::quiet_NaN() };
+	for(V b : boundaries) {
+		result.push_back(b);
+		result.push_back(std::nextafter(b, infinity));
+		result.push_back(std::nextafter(b, -infinity));
+	}
+	return result;
+}
+
+// domain_convert from numeric_domain<T> to numeric_domain<U>, computed with long double (before the final conversion to value_type_of<U>).
+// Integer computations round down (the offset from the minimum of the target domain is never negative), and floating-point ones truncate.
+// Static same-domain casts (identity) leave values unchanged.
+template <typename U, typename T>
+long double reference(const value_type_of<T> value, const bool identity) {
+	if(identity) return value;
+	const long double tmin = ::numeric_domain::numeric_domain<T>::min();
+	const long double tmax = ::numeric_domain::numeric_domain<T>::max();
+	const long double umin = ::numeric_domain::numeric_domain<U>::min();
+	const long double umax = ::numeric_domain::numeric_domain<U>::max();
+	const long double bounded = std::max(tmin, std::min(tmax, static_cast<long double>(value)));
+	const long double exact = umin + (bounded - tmin) * (umax - umin) / (tmax - tmin);
+	if(!std::is_integral<value_type_of<U>>::value) return exact;
+	return std::is_integral<value_type_of<T>>::value ? umin + std::floor((bounded - tmin) * (umax - umin) / (tmax - tmin)) : std::trunc(exact);
+}
+
+// Error of a converted value, in LSB for integer targets, and in ULP of the largest magnitude of the target domain for floating-point ones.
+template <typename U>
+double error(const value_type_of<U> value, const long double expected) {
+	if(value == expected || (std::isnan(static_cast<long double>(value)) && std::isnan(expected))) return 0;
+	const long double difference = std::fabs(static_cast<long double>(value) - expected);
+	if(std::is_integral<value_type_of<U>>::value) return static_cast<double>(difference);
+	const value_type_of<U> magnitude = static_cast<value_type_of<U>>(std::max(std::fabs(static_cast<long double>(::numeric_domain::numeric_domain<U>::min())), std::fabs(static_cast<long double>(::numeric_domain::numeric_domain<U>::max()))));
+	return static_cast<double>(difference / (std::nextafter(magnitude, std::numeric_limits<value_type_of<U>>::infinity()) - magnitude));
+}
+
+struct result {
+	double max_error;
+	std::string worst_input;
+	long long count;
+};
+
+struct job {
+	std::string pair;
+	std::string path;
+	double tolerance;
+	std::function<result()> run;
+	result outcome;
+};
+
+// Compare converted[i] with the reference conversion of values[i].
+template <typename U, typename T>
+result compare(const std::vector<value_type_of<T>>& values, const std::vector<value_type_of<U>>& converted, const bool identity) {
+	result r = { 0, "", static_cast<long long>(values.size()) };
+	for(std::size_t i = 0; i < values.size(); ++i) {
+		double e = error<U>(converted[i], reference<U,T>(values[i], identity));
+		if(e > r.max_error || (std::isnan(e) && !std::isnan(r.max_error))) {
+			r.max_error = e;
+			std::ostringstream oss;
+			oss << std::setprecision(9) << +values[i] << " -> " << +converted[i];
+			r.worst_input = oss.str();
+		}
+	}
+	return r;
+}
+
+// The cache file making every domain_autotuner of an integer source pick its lookup table, written before jobs run.
+const char* const autotune_cache = "verify.autotune";
+std::string& autotuned_tables() {
+	static std::string lines;
+	return lines;
+}
+
+// Lookup tables of make_domain_table, up to 12 bits, as they take long to compile.
+template <typename U, typename T>
+void add_domain_table_job(std::vector<job>& jobs, const std::string& pair, const double tolerance, std::true_type /* small */) {
+	typedef value_type_of<T> V;
+	typedef value_type_of<U> W;
+	jobs.push_back({ pair, "domain_table", tolerance, [=]() {
+		const domain_table<U,T> table = make_domain_table<U,T>();
+		std::vector<V> values = inputs<T>(std::true_type());
+		std::vector<W> converted(values.size());
+		for(std::size_t i = 0; i < values.size(); ++i) converted[i] = table(values[i]);
+		return compare<U,T>(values, converted, false);
+	}, result() });
+}
+template <typename U, typename T>
+void add_domain_table_job(std::vector<job>&, const std::string&, double, std::false_type /* small */) {}
+
+// Lookup tables, for integer sources: those of domain_autotuner and make_domain_table.
+template <typename U, typename T>
+void add_table_jobs(std::vector<job>& jobs, const std::string& pair, const double tolerance, std::true_type /* tabulable */) {
+	typedef value_type_of<T> V;
+	typedef value_type_of<U> W;
+	autotuned_tables() += std::string(typeid(domain_caster<U,T>).name()) + " table\n";
+	// Tables hold bounded values, even from numeric_domain<T> to itself.
+	jobs.push_back({ pair, "autotuned table", tolerance, [=]() {
+		const domain_autotuner<U,T> tuner(autotune_cache);
+		std::vector<V> values = inputs<T>(std::true_type());
+		std::vector<W> converted(values.size());
+		tuner(values.data(), values.data() + values.size(), converted.data());
+		result r = compare<U,T>(values, converted, false);
+		for(std::size_t i = 0; i < values.size(); ++i) converted[i] = tuner(values[i]);
+		result scalar = compare<U,T>(values, converted, false);
+		if(tuner.selected() != domain_autotuner<U,T>::strategy::table) return result { std::numeric_limits<double>::infinity(), "arithmetic strategy selected", 0 };
+		return scalar.max_error > r.max_error ? scalar : r;
+	}, result() });
+	add_domain_table_job<U,T>(jobs, pair, tolerance, std::integral_constant<bool, integer_extent<T>::value < 4096>());
+}
+template <typename U, typename T>
+void add_table_jobs(std::vector<job>&, const std::string&, double, std::false_type /* tabulable */) {}
+
+// In-place conversions, when value_type_of<U> fits in the memory of value_type_of<T>.
+template <typename U, typename T>
+void add_in_place_job(std::vector<job>& jobs, const std::string& pair, const double tolerance, const bool identity, std::true_type /* fits */) {
+	typedef value_type_of<T> V;
+	typedef value_type_of<U> W;
+	jobs.push_back({ pair, "in-place domain_cast", tolerance, [=]() {
+		std::vector<V> values = inputs<T>(std::is_integral<V>());
+		std::vector<V> buffer = values;
+		const W* converted = domain_cast_in_place<U,T>(buffer.data(), buffer.data() + buffer.size());
+		return compare<U,T>(values, std::vector<W>(converted, converted + values.size()), identity);
+	}, result() });
+}
+template <typename U, typename T>
+void add_in_place_job(std::vector<job>&, const std::string&, double, bool, std::false_type /* fits */) {}
+
+// Store values as described by a byte-order tag, stride bytes apart.
+template <typename Tag>
+std::vector<unsigned char> stored_bytes(const std::vector<value_type_of<typename byte_order_traits<Tag>::tag>>& values, const std::size_t stride) {
+	typedef typename byte_order_traits<Tag>::stored_type stored_type;
+	typedef typename unsigned_of_size<sizeof(stored_type)>::type bits_type;
+	std::vector<unsigned char> bytes(values.size() * stride + 1);
+	for(std::size_t i = 0; i < values.size(); ++i) {
+		const stored_type stored = static_cast<stored_type>(values[i]);
+		bits_type bits;
+		std::memcpy(&bits, &stored, sizeof(bits));
+		if(byte_order_traits<Tag>::swapped) bits = swap_bytes(bits);
+		// One byte in, so that values are unaligned.
+		std::memcpy(&bytes[1 + i * stride], &bits, sizeof(bits));
+	}
+	return bytes;
+}
+
+template <typename U, typename T>
+void add_pair(std::vector<job>& jobs) {
+	typedef value_type_of<T> V;
+	typedef value_type_of<U> W;
+	const std::string pair = name<T>() + " -> " + name<U>();
+	// Conversions computed only with integers must be exact; others may be off by one LSB, or by a few ULP of the target domain.
+	const bool integer = std::is_integral<V>::value && std::is_integral<W>::value;
+	const double tolerance = integer ? 0 : std::is_integral<W>::value ? 1 : 4;
+	const bool identity = std::is_same<U, T>::value;
+
+	jobs.push_back({ pair, "domain_cast", tolerance, [=]() {
+		std::vector<V> values = inputs<T>(std::is_integral<V>());
+		std::vector<W> converted(values.size());
+		for(std::size_t i = 0; i < values.size(); ++i) converted[i] = domain_cast<U,T>(values[i]);
+		return compare<U,T>(values, converted, identity);
+	}, result() });
+	jobs.push_back({ pair, "batch domain_cast", tolerance, [=]() {
+		std::vector<V> values = inputs<T>(std::is_integral<V>());
+		std::vector<W> converted(values.size());
+		domain_cast<U,T>(values.data(), values.data() + values.size(), converted.data());
+		return compare<U,T>(values, converted, identity);
+	}, result() });
+	jobs.push_back({ pair, "unchecked domain_cast", tolerance, [=]() {
+		std::vector<V> values = inputs<T>(std::is_integral<V>());
+		values.erase(std::remove_if(values.begin(), values.end(), [](V v) { return !(v >= ::numeric_domain::numeric_domain<T>::min() && v <= ::numeric_domain::numeric_domain<T>::max()); }), values.end());
+		std::vector<W> converted(values.size());
+		domain_cast<U,T,unchecked>(values.data(), values.data() + values.size(), converted.data());
+		return compare<U,T>(values, converted, identity);
+	}, result() });
+	jobs.push_back({ pair, "dynamic_domain_caster", tolerance, [=]() {
+		std::vector<V> values = inputs<T>(std::is_integral<V>());
+		std::vector<W> converted(values.size());
+		domain_cast(make_domain<U>(), values.data(), values.data() + values.size(), converted.data(), make_domain<T>());
+		return compare<U,T>(values, converted, false);
+	}, result() });
+	// Fanned-out outputs are bounded, even within numeric_domain<T> itself.
+	jobs.push_back({ pair, "domain_fan_out", tolerance, [=]() {
+		std::vector<V> values = inputs<T>(std::is_integral<V>());
+		std::vector<W> converted(values.size());
+		std::vector<float> floats(values.size());
+		domain_fan_out<T, float11, U>(values.data(), values.data() + values.size(), floats.data(), converted.data());
+		return compare<U,T>(values, converted, false);
+	}, result() });
+	// Coefficients are computed in floating point, so even integer conversions may be off by one LSB.
+	const double coefficient_tolerance = std::is_integral<W>::value ? 1 : 4;
+	jobs.push_back({ pair, "domain_coefficients", coefficient_tolerance, [=]() {
+		std::vector<V> values = inputs<T>(std::is_integral<V>());
+		std::vector<W> converted(values.size());
+		domain_transform(values.data(), values.data() + values.size(), converted.data(), make_coefficients(make_domain<U>(), make_domain<T>()));
+		return compare<U,T>(values, converted, false);
+	}, result() });
+	jobs.push_back({ pair, "domain_ramp", coefficient_tolerance, [=]() {
+		std::vector<V> values = inputs<T>(std::is_integral<V>());
+		std::vector<W> converted(values.size());
+		const auto coefficients = make_coefficients(make_domain<U>(), make_domain<T>());
+		domain_ramp(values.data(), values.data() + values.size(), converted.data(), coefficients, coefficients);
+		return compare<U,T>(values, converted, false);
+	}, result() });
+	add_in_place_job<U,T>(jobs, pair, tolerance, identity, std::integral_constant<bool, sizeof(W) <= sizeof(V)>());
+	jobs.push_back({ pair, "big-endian bytes", tolerance, [=]() {
+		std::vector<V> values = inputs<T>(std::is_integral<V>());
+		const std::vector<unsigned char> bytes = stored_bytes<big_endian<T, V>>(values, sizeof(V));
+		std::vector<W> converted(values.size());
+		domain_cast<U, big_endian<T, V>>(&bytes[1], values.size(), converted.data());
+		return compare<U,T>(values, converted, identity);
+	}, result() });
+	jobs.push_back({ pair, "strided little-endian", tolerance, [=]() {
+		std::vector<V> values = inputs<T>(std::is_integral<V>());
+		const std::size_t stride = sizeof(V) + 3;
+		const std::vector<unsigned char> bytes = stored_bytes<little_endian<T, V>>(values, stride);
+		std::vector<W> converted(values.size());
+		domain_cast<U, little_endian<T, V>>(&bytes[1], values.size(), converted.data(), stride);
+		return compare<U,T>(values, converted, identity);
+	}, result() });
+	add_table_jobs<U,T>(jobs, pair, tolerance, is_tabulable<T>());
+}
+
+template <typename T, typename... Us>
+void add_pairs_from(std::vector<job>& jobs, type_list<Us...>) {
+	int expand[] = { 0, (add_pair<Us,T>(jobs), 0)... };
+	(void)expand;
+}
+
+template <typename... Ts, typename Targets>
+void add_pairs(std::vector<job>& jobs, type_list<Ts...>, Targets t) {
+	int expand[] = { 0, (add_pairs_from<Ts>(jobs, t), 0)... };
+	(void)expand;
+}
+
+int main(int argc, char** argv) {
+	const bool verbose = argc > 1 && std::string(argv[1]) == "-v";
+
+	std::vector<job> jobs;
+	add_pairs(jobs, integer_sources(), targets());
+	add_pairs(jobs, floating_sources(), targets());
+	std::ofstream(autotune_cache) << autotuned_tables();
+
+	// Run jobs on every hardware thread.
+	std::atomic<std::size_t> next(0);
+	std::vector<std::thread> threads;
+	const unsigned thread_count = std::max(1u, std::thread::hardware_concurrency());
+	for(unsigned i = 0; i < thread_count; ++i) {
+		threads.emplace_back([&]() {
+			for(std::size_t j = next++; j < jobs.size(); j = next++) {
+				jobs[j].outcome = jobs[j].run();
+			}
+		});
+	}
+	for(std::thread& thread : threads) {
+		thread.join();
+	}
+
+	std::remove(autotune_cache);
+
+	// Report the maximum error of each path, per pair and overall.
+	int failures = 0;
+	std::size_t pairs = 0;
+	long long conversions = 0;
+	std::vector<std::string> paths;
+	std::vector<double> worst;
+	for(std::size_t k = 0; k < jobs.size(); ++k) {
+		const job& j = jobs[k];
+		// Jobs of a pair are added together.
+		pairs += k == 0 || j.pair != jobs[k - 1].pair;
+		conversions += j.outcome.count;
+		const bool failed = !(j.outcome.max_error <= j.tolerance);
+		failures += failed;
+		if(verbose || failed) {
+			std::cout << (failed ? "FAILED: " : "") << std::left << std::setw(48) << j.pair << std::setw(24) << j.path << " max error " << j.outcome.max_error << " (tolerance " << j.tolerance << ")";
+			if(!j.outcome.worst_input.empty()) std::cout << ", at " << j.outcome.worst_input;
+			std::cout << std::endl;
+		}
+		std::size_t p = std::find(paths.begin(), paths.end(), j.path) - paths.begin();
+		if(p == paths.size()) {
+			paths.push_back(j.path);
+			worst.push_back(0);
+		}
+		worst[p] = std::max(worst[p], j.outcome.max_error);
+	}
+	std::cout << pairs << " pairs, " << conversions << " conversions checked on " << thread_count << " threads" << std::endl;
+	for(std::size_t p = 0; p < paths.size(); ++p) {
+		std::cout << "  " << std::left << std::setw(24) << paths[p] << " max error " << worst[p] << std::endl;
+	}
+	std::cout << (failures ? "FAILED" : "OK") << std::endl;
+	return failures == 0 ? 0 : 1;
+}